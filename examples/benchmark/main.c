@@ -0,0 +1,314 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <isotplib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+/*
+    ISOTPlib microbenchmark
+
+    Runs in-memory loopback sender/receiver session pairs and reports throughput of the session hot paths.
+    One JSON object is printed per configuration (JSON lines) so results can be tracked over time.
+
+    Usage: benchmark [--max-size BYTES] [--min-time-ms MS]
+        --max-size      Largest payload to test (default 16777216, use 4294967295 for the full 4 GB CAN FD sweep)
+        --min-time-ms   Minimum measurement time per configuration (default 50)
+
+    "mem_assign" counts receive buffer requests made by the library through `callback_mem_assign`.
+    "allocs" counts heap allocations during the measurement and is only tracked when built with -DBENCH_WRAP_MALLOC
+    and linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (see the vscode task).
+*/
+
+//  Allocation counting (linker wrapped)
+static size_t alloc_count = 0;
+static size_t mem_assign_count = 0;
+
+#ifdef BENCH_WRAP_MALLOC
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) { alloc_count++; return __real_malloc(size); }
+void* __wrap_calloc(size_t count, size_t size) { alloc_count++; return __real_calloc(count, size); }
+void* __wrap_realloc(void* ptr, size_t size) { alloc_count++; return __real_realloc(ptr, size); }
+#endif
+
+//  Payload source: a repeating pattern block, borrowed as fragments so payloads can exceed RAM
+#define PATTERN_SIZE 65536
+static uint8_t pattern[PATTERN_SIZE];
+
+//  Receive buffer for payloads that fit, larger payloads stream into a counting sink
+#define RX_BUFFER_SIZE 4096
+static uint8_t rx_buffer[RX_BUFFER_SIZE];
+static uint8_t tx_buffer[8];
+
+typedef struct {
+    const char* name;
+    isotp_format_t format;
+    size_t frame_size;
+    size_t max_payload;
+} bench_format_t;
+
+static const bench_format_t formats[] = {
+    { "NORMAL", ISOTP_FORMAT_NORMAL, 8, 4095 },
+    { "FD", ISOTP_FORMAT_FD, 64, UINT32_MAX },
+    { "LIN", ISOTP_FORMAT_LIN, 8, 4095 },
+};
+
+static const uint64_t payload_sizes[] = {
+    1, 6, 7, 62, 63, 256, 4095, 65536, 1048576, 16777216, 268435456, UINT32_MAX
+};
+
+static const uint8_t block_sizes[] = { 0, 8, 32 };
+
+//  Loopback state
+static bool rx_complete = false;
+static uint64_t sink_bytes = 0;
+
+static void cb_transmission_rx(void* context) {
+    rx_complete = true;
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_error(void* context, const uint8_t* data, const size_t length) {
+    (void)data;
+    (void)length;
+    fprintf(stderr, "[ERR] Transfer error\n");
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_error_invalid_frame(void* context, const isotp_spec_frame_type_t type, const uint8_t* data, const size_t length) {
+    (void)type;
+    (void)data;
+    (void)length;
+    fprintf(stderr, "[ERR] Invalid frame\n");
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_error_too_large(void* context, const uint8_t* data, const size_t length, const size_t requested_size) {
+    (void)data;
+    (void)length;
+    (void)requested_size;
+    fprintf(stderr, "[ERR] Transmission too large\n");
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_error_out_of_order(void* context, const uint8_t* data, const size_t length, const uint8_t expected, const uint8_t received) {
+    (void)data;
+    (void)length;
+    (void)expected;
+    (void)received;
+    fprintf(stderr, "[ERR] Consecutive out of order\n");
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_mem_assign(void* context, const size_t indicated_length) {
+    (void)context;
+    (void)indicated_length;
+    mem_assign_count++;
+}
+
+static size_t sink_write(void* context, const uint8_t* data, const size_t length, const size_t offset) {
+    (void)context;
+    (void)data;
+    (void)offset;
+    sink_bytes += length;
+    return length;
+}
+
+static const isotp_rx_sink_t counting_sink = { sink_write, NULL, NULL };
+
+static void setup_session(isotp_session_t* session, const bench_format_t* format, bool padding, uint8_t block_size) {
+    isotp_session_init(session, format->format, tx_buffer, sizeof(tx_buffer), rx_buffer, sizeof(rx_buffer));
+    session->protocol_config.padding_enabled = padding;
+    session->protocol_config.fc_default_request_size = block_size;
+    session->callback_transmission_rx = cb_transmission_rx;
+    session->callback_mem_assign = cb_mem_assign;
+    session->callback_error_invalid_frame = cb_error_invalid_frame;
+    session->callback_error_partner_aborted_transfer = cb_error;
+    session->callback_error_transmission_too_large = cb_error_too_large;
+    session->callback_error_consecutive_out_of_order = cb_error_out_of_order;
+    session->callback_error_unexpected_frame_type = cb_error;
+    isotp_session_idle(session);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+//  Moves a single transfer through the loopback pair, returns frames exchanged (0 = failed)
+static uint64_t run_transfer(isotp_session_t* sender, isotp_session_t* receiver, const isotp_tx_fragment_t* fragments, size_t fragment_count, size_t frame_size, bool batch) {
+    isotp_can_frame_t frames[32];
+    uint8_t frame[ISOTP_CAN_FRAME_MAX_SIZE];
+    uint64_t frame_count = 0;
+
+    rx_complete = false;
+    if(isotp_session_send_fragments(sender, fragments, fragment_count) == 0) {
+        return 0;
+    }
+
+    while(!rx_complete) {
+        size_t moved = 0;
+
+        if(batch) {
+            size_t n = isotp_session_can_tx_batch(sender, frames, 32, frame_size, NULL);
+            isotp_session_can_rx_batch(receiver, frames, n);
+            moved += n;
+
+            n = isotp_session_can_tx_batch(receiver, frames, 1, frame_size, NULL);
+            isotp_session_can_rx_batch(sender, frames, n);
+            moved += n;
+        }
+        else {
+            size_t len = isotp_session_can_tx(sender, frame, frame_size, NULL);
+            if(len > 0) { isotp_session_can_rx(receiver, frame, len); moved++; }
+
+            len = isotp_session_can_tx(receiver, frame, frame_size, NULL);
+            if(len > 0) { isotp_session_can_rx(sender, frame, len); moved++; }
+        }
+
+        //  Stalled
+        if(moved == 0) {
+            return 0;
+        }
+
+        frame_count += moved;
+    }
+
+    return frame_count;
+}
+
+static void run_config(const bench_format_t* format, uint64_t payload, bool padding, uint8_t block_size, bool batch, uint64_t min_time_ns) {
+    isotp_session_t sender, receiver;
+    setup_session(&sender, format, padding, block_size);
+    setup_session(&receiver, format, padding, block_size);
+
+    //  Large payloads stream into the sink
+    const bool use_sink = payload > RX_BUFFER_SIZE;
+    if(use_sink) {
+        isotp_session_use_rx_sink(&receiver, &counting_sink);
+    }
+
+    //  Describe payload as pattern fragments
+    size_t fragment_count = (size_t)((payload + PATTERN_SIZE - 1) / PATTERN_SIZE);
+    isotp_tx_fragment_t* fragments = (isotp_tx_fragment_t*)malloc(fragment_count * sizeof(isotp_tx_fragment_t));
+    if(fragments == NULL) {
+        fprintf(stderr, "[ERR] Out of memory\n");
+        return;
+    }
+
+    uint64_t remaining = payload;
+    for(size_t i = 0; i < fragment_count; i++) {
+        fragments[i].data = pattern;
+        fragments[i].length = (remaining > PATTERN_SIZE) ? PATTERN_SIZE : (size_t)remaining;
+        remaining -= fragments[i].length;
+    }
+
+    //  Measure
+    sink_bytes = 0;
+    uint64_t transfers = 0;
+    uint64_t frame_count = 0;
+    const size_t allocs_start = alloc_count;
+    const size_t mem_assign_start = mem_assign_count;
+    const uint64_t cycles_start = now_cycles();
+    const uint64_t time_start = now_ns();
+    uint64_t elapsed_ns = 0;
+
+    do {
+        uint64_t frames = run_transfer(&sender, &receiver, fragments, fragment_count, format->frame_size, batch);
+        if(frames == 0) {
+            fprintf(stderr, "[ERR] Transfer stalled: %s %llu bytes\n", format->name, (unsigned long long)payload);
+            break;
+        }
+
+        frame_count += frames;
+        transfers++;
+        elapsed_ns = now_ns() - time_start;
+    } while(elapsed_ns < min_time_ns);
+
+    const uint64_t cycles = now_cycles() - cycles_start;
+    const size_t allocs = alloc_count - allocs_start;
+    const size_t mem_assigns = mem_assign_count - mem_assign_start;
+    free(fragments);
+
+    if(frame_count == 0) {
+        return;
+    }
+
+    //  Sanity check streamed data
+    if(use_sink && sink_bytes != payload * transfers) {
+        fprintf(stderr, "[ERR] Sink received %llu of %llu bytes\n", (unsigned long long)sink_bytes, (unsigned long long)(payload * transfers));
+    }
+
+    const double seconds = (double)elapsed_ns / 1e9;
+    printf("{\"format\":\"%s\",\"api\":\"%s\",\"payload_bytes\":%llu,\"padding\":%s,\"block_size\":%u,\"rx\":\"%s\","
+           "\"transfers\":%llu,\"frames\":%llu,\"ns_per_frame\":%.2f,\"cycles_per_frame\":%.2f,\"bytes_per_sec\":%.0f,\"mem_assign\":%zu,\"allocs\":%zu}\n",
+           format->name, batch ? "batch" : "frame", (unsigned long long)payload, padding ? "true" : "false", block_size, use_sink ? "sink" : "buffer",
+           (unsigned long long)transfers, (unsigned long long)frame_count,
+           (double)elapsed_ns / (double)frame_count, (double)cycles / (double)frame_count,
+           (double)(payload * transfers) / seconds, mem_assigns, allocs);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    uint64_t max_size = 16777216;
+    uint64_t min_time_ms = 50;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = strtoull(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            min_time_ms = strtoull(argv[++i], NULL, 10);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--max-size BYTES] [--min-time-ms MS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for(size_t i = 0; i < PATTERN_SIZE; i++) {
+        pattern[i] = (uint8_t)i;
+    }
+
+    for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for(size_t p = 0; p < sizeof(payload_sizes) / sizeof(payload_sizes[0]); p++) {
+            const uint64_t payload = payload_sizes[p];
+            if(payload > formats[f].max_payload || payload > max_size) {
+                continue;
+            }
+
+            for(int padding = 1; padding >= 0; padding--) {
+                for(size_t b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++) {
+                    //  LIN has no flow control
+                    if(formats[f].format == ISOTP_FORMAT_LIN && block_sizes[b] != 0) {
+                        continue;
+                    }
+
+                    run_config(&formats[f], payload, padding, block_sizes[b], false, min_time_ms * 1000000ULL);
+                    run_config(&formats[f], payload, padding, block_sizes[b], true, min_time_ms * 1000000ULL);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
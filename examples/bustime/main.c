@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <isotplib.h>
+
+/*
+    ISOTPlib bus time estimator
+
+    Predicts on-wire time, latency and throughput of a session configuration with `isotp_bustime_estimate` and prints
+    the configuration `isotp_bustime_recommend` suggests. One JSON object is printed per payload (JSON lines).
+    The frame layout of the model is checked against an in-memory loopback by `tests/bustime.c`.
+
+    Usage: bustime [options]
+        --format F          normal or fd (default fd)
+        --frame-size N      Frame size passed to the session (default 8 for normal, 64 for fd)
+        --bitrate N         Nominal bit rate in bit/s (default 500000)
+        --data-bitrate N    CAN FD data phase bit rate in bit/s, 0 = no bit rate switch (default 2000000)
+        --extended-id       29 bit identifiers
+        --addressing A      normal, extended or mixed (default normal)
+        --no-padding        Disable padding
+        --planned           Plan the CAN FD frame size (TX_DL) of each message
+        --block-size N      Flow control block size (default 0)
+        --stmin-us N        Flow control separation time in uS (default 0)
+        --gap-us N          Sender gap between frames in uS (default 0)
+        --response-us N     Node response time to a frame in uS (default 100)
+        --rx-frame-us N     Receiver processing time per frame in uS (default 0)
+        --rx-fifo N         Receiver FIFO depth in frames, 0 = unlimited (default 0)
+        --payload N         Payload size (default: sweep)
+
+    Times are modeled, nothing is sent on a bus.
+*/
+
+static const size_t payload_sizes[] = { 1, 7, 62, 63, 256, 1024, 4095, 4096, 65536 };
+
+static const char* addressing_name(const isotp_addressing_t mode) {
+    switch(mode) {
+        case ISOTP_ADDRESSING_EXTENDED: return "extended";
+        case ISOTP_ADDRESSING_MIXED: return "mixed";
+        default: return "normal";
+    }
+}
+
+static void run_payload(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* config, const size_t payload) {
+    isotp_bustime_estimate_t estimate;
+    if(!isotp_bustime_estimate(link, config, payload, &estimate)) {
+        fprintf(stderr, "[ERR] No estimate for %zu bytes (frame size or payload out of range for the format)\n", payload);
+        return;
+    }
+
+    printf("{\"payload_bytes\":%zu,\"format\":\"%s\",\"frame_size\":%zu,\"addressing\":\"%s\",\"padding\":%s,\"planned\":%s,\"block_size\":%zu,\"stmin_us\":%lu,"
+           "\"data_frames\":%zu,\"fc_frames\":%zu,\"bytes_on_wire\":%zu,\"bus_time_avg_us\":%.1f,\"bus_time_worst_us\":%.1f,"
+           "\"latency_avg_us\":%lu,\"latency_worst_us\":%lu,\"throughput_avg_Bps\":%lu,\"throughput_worst_Bps\":%lu,\"bus_load_permille\":%u,\"rx_overrun\":%s,",
+           payload, (config->frame_format == ISOTP_FORMAT_FD) ? "FD" : "NORMAL", link->frame_size, addressing_name(config->addressing_mode),
+           config->padding_enabled ? "true" : "false", config->fd_tx_dl_planned ? "true" : "false",
+           config->fc_default_request_size, (unsigned long)config->fc_default_separation_time,
+           estimate.data_frames, estimate.fc_frames, estimate.bytes_on_wire,
+           (double)estimate.bus_time_avg_nS / 1e3, (double)estimate.bus_time_worst_nS / 1e3,
+           (unsigned long)estimate.latency_avg_uS, (unsigned long)estimate.latency_worst_uS,
+           (unsigned long)estimate.throughput_avg_Bps, (unsigned long)estimate.throughput_worst_Bps,
+           estimate.bus_load_permille, estimate.rx_overrun ? "true" : "false");
+
+    //  Suggested configuration
+    isotp_session_protocol_config_t recommended;
+    isotp_bustime_estimate_t recommended_estimate;
+    if(isotp_bustime_recommend(link, config, payload, &recommended, &recommended_estimate)) {
+        printf("\"recommended\":{\"planned\":%s,\"block_size\":%zu,\"stmin_us\":%lu,\"latency_avg_us\":%lu,\"throughput_avg_Bps\":%lu}}\n",
+               recommended.fd_tx_dl_planned ? "true" : "false", recommended.fc_default_request_size, (unsigned long)recommended.fc_default_separation_time,
+               (unsigned long)recommended_estimate.latency_avg_uS, (unsigned long)recommended_estimate.throughput_avg_Bps);
+    }
+    else {
+        printf("\"recommended\":null}\n");
+    }
+
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    isotp_bustime_link_t link = { 0 };
+    link.nominal_bitrate = 500000;
+    link.data_bitrate = 2000000;
+    link.response_uS = 100;
+
+    isotp_session_t defaults;
+    isotp_session_init(&defaults, ISOTP_FORMAT_FD, NULL, 0, NULL, 0);
+    isotp_session_protocol_config_t config = defaults.protocol_config;
+    config.frame_format = ISOTP_FORMAT_FD;
+
+    size_t payload = 0;
+    for(int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        if(strcmp(argv[i], "--format") == 0 && has_value) {
+            config.frame_format = (strcmp(argv[++i], "normal") == 0) ? ISOTP_FORMAT_NORMAL : ISOTP_FORMAT_FD;
+        }
+        else if(strcmp(argv[i], "--frame-size") == 0 && has_value) {
+            link.frame_size = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--bitrate") == 0 && has_value) {
+            link.nominal_bitrate = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--data-bitrate") == 0 && has_value) {
+            link.data_bitrate = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--extended-id") == 0) {
+            link.extended_id = true;
+        }
+        else if(strcmp(argv[i], "--addressing") == 0 && has_value) {
+            i++;
+            config.addressing_mode = (strcmp(argv[i], "extended") == 0) ? ISOTP_ADDRESSING_EXTENDED :
+                                     (strcmp(argv[i], "mixed") == 0) ? ISOTP_ADDRESSING_MIXED : ISOTP_ADDRESSING_NORMAL;
+        }
+        else if(strcmp(argv[i], "--no-padding") == 0) {
+            config.padding_enabled = false;
+        }
+        else if(strcmp(argv[i], "--planned") == 0) {
+            config.fd_tx_dl_planned = true;
+        }
+        else if(strcmp(argv[i], "--block-size") == 0 && has_value) {
+            config.fc_default_request_size = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--stmin-us") == 0 && has_value) {
+            config.fc_default_separation_time = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--gap-us") == 0 && has_value) {
+            link.frame_gap_uS = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--response-us") == 0 && has_value) {
+            link.response_uS = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--rx-frame-us") == 0 && has_value) {
+            link.rx_frame_uS = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--rx-fifo") == 0 && has_value) {
+            link.rx_fifo_frames = strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "--payload") == 0 && has_value) {
+            payload = strtoul(argv[++i], NULL, 10);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--format normal|fd] [--frame-size N] [--bitrate N] [--data-bitrate N] [--extended-id] [--addressing normal|extended|mixed]\n"
+                            "       [--no-padding] [--planned] [--block-size N] [--stmin-us N] [--gap-us N] [--response-us N] [--rx-frame-us N] [--rx-fifo N] [--payload N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if(link.frame_size == 0) {
+        link.frame_size = (config.frame_format == ISOTP_FORMAT_FD) ? ISOTP_CAN_FRAME_MAX_SIZE : 8;
+    }
+
+    if(payload != 0) {
+        run_payload(&link, &config, payload);
+    }
+    else {
+        for(size_t p = 0; p < sizeof(payload_sizes) / sizeof(payload_sizes[0]); p++) {
+            run_payload(&link, &config, payload_sizes[p]);
+        }
+    }
+
+    return 0;
+}
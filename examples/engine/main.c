@@ -0,0 +1,168 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <isotplib.h>
+#include <isotp_engine.h>
+
+/*
+    Sharded engine example (Linux)
+
+    Runs tester/ECU session pairs inside an `isotp_engine_t` and loops every frame the workers transmit straight back
+    into the engine, as if all sessions shared one bus. Testers send a request, ECUs echo it and testers immediately
+    send the next one. The main thread plays the bus I/O thread and only moves frames.
+
+    Usage: engine [workers] [pairs] [payload size] [seconds]
+        workers         Worker threads / shards (default: online CPUs)
+        pairs           Tester/ECU session pairs (default 100, 200 sessions)
+        payload size    Request size in bytes (default 512)
+        seconds         Run time (default 2)
+
+    Compare frames_per_sec across worker counts to see how throughput scales on the machine.
+*/
+
+#define MAX_WORKERS 64
+#define TESTER_RX_BASE 0x100
+#define ECU_RX_BASE 0x500
+
+//  One aligned shard per worker (static storage keeps the cache line alignment)
+static isotp_engine_shard_t shards[MAX_WORKERS];
+static isotp_engine_t engine;
+
+static uint8_t* request;
+static size_t payload_size = 512;
+static uint64_t transfers = 0;
+
+static void ecu_rx(void* context) {
+    //  Echo (runs on a worker thread, the session may be sent on directly)
+    isotp_session_t* session = (isotp_session_t*)context;
+    isotp_session_send(session, session->rx_buffer, session->full_transmission_length);
+}
+
+static void tester_rx(void* context) {
+    //  Next request
+    isotp_session_t* session = (isotp_session_t*)context;
+    __atomic_add_fetch(&transfers, 1, __ATOMIC_RELAXED);
+    isotp_session_send(session, request, payload_size);
+}
+
+static void on_error(void* context, const uint8_t* data, const size_t length) {
+    (void)data;
+    (void)length;
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void tester_timeout(void* context, const isotp_session_timer_t timer) {
+    (void)timer;
+
+    //  A frame was dropped (shard queue full), start over
+    isotp_session_send((isotp_session_t*)context, request, payload_size);
+}
+
+//  Callback tables shared by all testers and all ECUs (context = the session)
+static const isotp_session_ops_t tester_ops = {
+    .callback_transmission_rx = tester_rx,
+    .callback_error_partner_aborted_transfer = on_error,
+    .callback_error_unexpected_frame_type = on_error,
+    .callback_time_uS = isotp_engine_time_uS,
+    .callback_error_timeout = tester_timeout,
+};
+
+static const isotp_session_ops_t ecu_ops = {
+    .callback_transmission_rx = ecu_rx,
+    .callback_error_partner_aborted_transfer = on_error,
+    .callback_error_unexpected_frame_type = on_error,
+    .callback_time_uS = isotp_engine_time_uS,
+};
+
+static void setup_session(isotp_session_t* session, const isotp_session_ops_t* ops) {
+    isotp_session_init(session, ISOTP_FORMAT_FD, malloc(payload_size), payload_size, malloc(payload_size), payload_size);
+    isotp_session_use_ops(session, ops, NULL);
+}
+
+int main(int argc, char** argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t workers = (argc > 1) ? strtoul(argv[1], NULL, 10) : (size_t)((cpus > 0) ? cpus : 1);
+    size_t pairs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 100;
+    if(argc > 3) { payload_size = strtoul(argv[3], NULL, 10); }
+    unsigned seconds = (argc > 4) ? (unsigned)strtoul(argv[4], NULL, 10) : 2;
+
+    if(workers == 0 || workers > MAX_WORKERS) { workers = 1; }
+    if(payload_size == 0) { payload_size = 512; }
+
+    request = malloc(payload_size);
+    for(size_t i = 0; i < payload_size; i++) {
+        request[i] = (uint8_t)i;
+    }
+
+    //  Engine & sessions
+    if(!isotp_engine_init(&engine, shards, workers, 64)) {
+        printf("[ERR] Unable to initialize engine\n");
+        return 1;
+    }
+
+    //  Sessions are cache line aligned, which calloc does not guarantee
+    isotp_session_t* testers = aligned_alloc(ISOTP_SESSION_CACHE_LINE, pairs * sizeof(isotp_session_t));
+    isotp_session_t* ecus = aligned_alloc(ISOTP_SESSION_CACHE_LINE, pairs * sizeof(isotp_session_t));
+    memset(testers, 0, pairs * sizeof(isotp_session_t));
+    memset(ecus, 0, pairs * sizeof(isotp_session_t));
+    for(size_t i = 0; i < pairs; i++) {
+        setup_session(&testers[i], &tester_ops);
+        setup_session(&ecus[i], &ecu_ops);
+
+        if(!isotp_engine_add(&engine, &testers[i], TESTER_RX_BASE + (uint32_t)i, ECU_RX_BASE + (uint32_t)i) ||
+           !isotp_engine_add(&engine, &ecus[i], ECU_RX_BASE + (uint32_t)i, TESTER_RX_BASE + (uint32_t)i)) {
+            printf("[ERR] Shard full, use more workers or raise ISOTP_ENGINE_SHARD_SESSIONS\n");
+            return 1;
+        }
+
+        //  First request, picked up once the workers start
+        isotp_session_send(&testers[i], request, payload_size);
+    }
+
+    if(!isotp_engine_start(&engine)) {
+        printf("[ERR] Unable to start workers\n");
+        return 1;
+    }
+
+    //  Bus I/O: everything transmitted is recieved by the session listening on that identifier
+    static isotp_can_frame_t frames[256];
+    const uint64_t start_uS = isotp_engine_time_uS(NULL);
+    const uint64_t end_uS = start_uS + (uint64_t)seconds * 1000000ULL;
+    uint64_t bus_frames = 0;
+
+    while(isotp_engine_time_uS(NULL) < end_uS) {
+        size_t count = isotp_engine_collect_tx(&engine, frames, sizeof(frames) / sizeof(frames[0]));
+        if(count == 0) {
+            sched_yield();
+            continue;
+        }
+
+        bus_frames += count;
+
+        //  Retry what full shard queues did not accept, in order
+        size_t dispatched = 0;
+        while(dispatched < count && isotp_engine_time_uS(NULL) < end_uS) {
+            dispatched += isotp_engine_dispatch(&engine, frames + dispatched, count - dispatched);
+            if(dispatched < count) { sched_yield(); }
+        }
+    }
+
+    const double elapsed = (double)(isotp_engine_time_uS(NULL) - start_uS) / 1e6;
+    isotp_engine_stop(&engine);
+
+    //  Results
+    uint64_t stolen = 0;
+    uint32_t dropped = 0;
+    for(size_t idx = 0; idx < workers; idx++) {
+        stolen += shards[idx].frames_stolen;
+        dropped += isotp_frame_queue_dropped(&shards[idx].rx_queue);
+    }
+
+    printf("{\"workers\":%zu,\"sessions\":%zu,\"payload_bytes\":%zu,\"frames_per_sec\":%.0f,\"transfers_per_sec\":%.0f,\"stolen_frames\":%llu,\"dropped_frames\":%lu}\n",
+        workers, pairs * 2, payload_size, (double)bus_frames / elapsed, (double)transfers / elapsed, (unsigned long long)stolen, (unsigned long)dropped);
+
+    return 0;
+}
@@ -2,8 +2,10 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "driver/twai.h"
 #include "isotp_session.h"
+#include "isotp_frame_queue.h"
 
 //  TWAI
 #define TX_GPIO_NUM 21
@@ -19,6 +21,13 @@ static isotp_session_t can_session;
 static uint8_t tx_buf[512];
 static uint8_t rx_buf[512];
 
+//  Recieved frames, pushed by the RX task and pumped into the session by the CAN task
+static isotp_frame_queue_t rx_queue;
+static isotp_can_frame_t rx_queue_frames[32];
+
+//  CAN task, notified by the RX task for every queued frame
+static TaskHandle_t can_task_handle;
+
 // Callbacks
 void transmission_rx_callback(void* context) {
     //  Example: Respond with the same message but reversed
@@ -35,6 +44,23 @@ void error_callback(void* context, const uint8_t* msg_data, const size_t msg_len
     isotp_session_idle((isotp_session_t*)context);
 }
 
+//  Monotonic clock used by the session for separation time & timeouts
+uint64_t clock_callback(void* context) {
+    return (uint64_t)esp_timer_get_time();
+}
+
+// RX Task: only moves frames off the driver, so reception keeps up at high bus load
+void CAN_rx_task(void *arg) {
+    twai_message_t rx_msg;
+
+    while (1) {
+        if (twai_receive(&rx_msg, portMAX_DELAY) == ESP_OK && rx_msg.identifier == CAN_ID_INCOMING_REQUEST) {
+            isotp_frame_queue_push(&rx_queue, rx_msg.identifier, rx_msg.data, rx_msg.data_length_code, (uint64_t)esp_timer_get_time());
+            xTaskNotifyGive(can_task_handle);
+        }
+    }
+}
+
 // CAN Task
 void CAN_task(void *arg) {
     // Configure TWAI driver
@@ -51,27 +77,45 @@ void CAN_task(void *arg) {
         vTaskDelete(NULL);
     }
 
-    twai_message_t rx_msg;
+    //  Reception runs at a higher priority than session processing
+    can_task_handle = xTaskGetCurrentTaskHandle();
+    xTaskCreate(CAN_rx_task, "CAN_rx_task", 2048, NULL, 6, NULL);
 
-    // Infinite loop to read messages from the CAN bus
+    // Infinite loop to process messages from the CAN bus
     while (1) {
-        //  Recieve
-        if (twai_receive(&rx_msg, 0) == ESP_OK) {
-            if (rx_msg.identifier == CAN_ID_INCOMING_REQUEST) {
-                isotp_session_can_rx(&can_session, rx_msg.data, rx_msg.data_length_code);
+        //  Recieve (callbacks run here, in task context)
+        isotp_frame_queue_pump_session(&rx_queue, &can_session, 0);
+
+        //  Send once the session is due (separation time is tracked by the session)
+        if(isotp_session_next_tx_due(&can_session) <= (uint64_t)esp_timer_get_time()) {
+            twai_message_t tx_msg = {0};
+
+            size_t uds_tx_len = isotp_session_can_tx(&can_session, tx_msg.data, sizeof(tx_msg.data), NULL);
+            if(uds_tx_len > 0) {
+                tx_msg.identifier = CAN_ID_OUTGOING_RESPONSE;
+                tx_msg.data_length_code = uds_tx_len;
+                twai_transmit(&tx_msg, 0);
             }
         }
 
-        //  Send
-        static next_tx_time_uS = 0;
-        if(next_tx_time_uS >= esp_timer_get_time()) {
-            twai_message_t tx_msg;
+        //  Expire timeouts
+        isotp_session_tick(&can_session, (uint64_t)esp_timer_get_time());
 
-            uint32_t requested_separation_uS;
-            size_t uds_tx_len = isotp_session_can_tx(can_session, tx_msg.data, tx_msg.data_length_code, &requested_separation_uS);
+        //  Sleep until the next frame or timeout is due, or the RX task queued a frame
+        uint64_t wake_uS = isotp_session_next_tx_due(&can_session);
+        if(can_session.deadline_uS < wake_uS) {
+            wake_uS = can_session.deadline_uS;
+        }
 
-            next_tx_time_uS = esp_timer_get_time() + requested_separation_uS;
+        TickType_t wait_ticks = portMAX_DELAY;
+        if(wake_uS != ISOTP_SESSION_DEADLINE_NONE) {
+            //  Rounded up, so the task does not wake just before the due time
+            const uint64_t now_uS = (uint64_t)esp_timer_get_time();
+            const uint64_t tick_uS = (uint64_t)portTICK_PERIOD_MS * 1000;
+            wait_ticks = (wake_uS > now_uS) ? (TickType_t)((wake_uS - now_uS + tick_uS - 1) / tick_uS) : 0;
         }
+
+        ulTaskNotifyTake(pdTRUE, wait_ticks);
     }
 
     // Clean up on task exit
@@ -89,6 +133,8 @@ void app_main() {
     can_session.callback_error_transmission_too_large = error_callback;
     can_session.callback_error_consecutive_out_of_order = error_callback;
     can_session.callback_error_unexpected_frame_type = error_callback;
+    can_session.callback_time_uS = clock_callback;
+    isotp_frame_queue_init(&rx_queue, rx_queue_frames, NULL, sizeof(rx_queue_frames) / sizeof(rx_queue_frames[0]));
 
     // Create the CAN task
     xTaskCreate(CAN_task, "CAN_task", 4096, NULL, 5, NULL);
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <isotplib.h>
+#include <isotp_socketcan.h>
+
+/*
+    SocketCAN example (Linux)
+
+    A tester and an ECU session exchange messages over a CAN interface, each through its own socket,
+    driven from a single epoll loop. The ECU requests a separation time, which the loop honors using
+    its timerfd instead of sleeping or polling.
+
+    Try it on a virtual interface:
+        sudo ip link add dev vcan0 type vcan && sudo ip link set up vcan0
+        ./socketcan vcan0 [payload size] [count]
+*/
+
+#define TESTER_TX_ID 0x7E0
+#define ECU_TX_ID 0x7E8
+
+//  Sessions & buffers
+isotp_session_t tester;
+isotp_session_t ecu;
+uint8_t tester_rx_buffer[4095];
+uint8_t ecu_rx_buffer[4095];
+uint8_t tester_tx_buffer[4095];
+uint8_t ecu_tx_buffer[4095];
+uint8_t request[4095];
+
+//  One router and socket per node (a real gateway registers all of its sessions with one router)
+isotp_router_entry_t tester_entries[4];
+isotp_router_entry_t ecu_entries[4];
+isotp_router_t tester_router;
+isotp_router_t ecu_router;
+struct can_filter tester_filters[4];
+struct can_filter ecu_filters[4];
+isotp_socketcan_t tester_iface;
+isotp_socketcan_t ecu_iface;
+
+//  Timeouts for both sessions
+isotp_session_t* timer_slots[2];
+isotp_timer_heap_t timer_heap;
+
+size_t messages_remaining = 0;
+size_t payload_size = 256;
+bool awaiting_echo = false;
+
+void ecu_rx(void* context) {
+    //  Echo request back to tester
+    isotp_session_t* session = (isotp_session_t*)context;
+    size_t len = session->full_transmission_length;
+    printf("[ECU] Recieved %zu bytes, echoing\n", len);
+    isotp_session_send(session, session->rx_buffer, len);
+}
+
+void tester_rx(void* context) {
+    isotp_session_t* session = (isotp_session_t*)context;
+    printf("[TESTER] Echo of %zu bytes recieved\n", session->full_transmission_length);
+    isotp_session_idle(session);
+    awaiting_echo = false;
+
+    //  Next request
+    if(messages_remaining > 0) {
+        messages_remaining--;
+        awaiting_echo = isotp_session_send(session, request, payload_size) > 0;
+    }
+}
+
+void on_timeout(void* context, const isotp_session_timer_t timer) {
+    printf("[ERR] Session timed out (timer %d)\n", (int)timer);
+    isotp_session_idle((isotp_session_t*)context);
+    awaiting_echo = false;
+    messages_remaining = 0;
+}
+
+void setup_session(isotp_session_t* session, uint8_t* tx_buffer, size_t tx_len, uint8_t* rx_buffer, size_t rx_len) {
+    isotp_session_init(session, ISOTP_FORMAT_NORMAL, tx_buffer, tx_len, rx_buffer, rx_len);
+    session->callback_time_uS = isotp_socketcan_time_uS;
+    session->callback_error_timeout = on_timeout;
+    isotp_timer_heap_attach(&timer_heap, session);
+}
+
+int main(int argc, char** argv) {
+    const char* ifname = (argc > 1) ? argv[1] : "vcan0";
+    if(argc > 2) { payload_size = strtoul(argv[2], NULL, 10); }
+    if(argc > 3) { messages_remaining = strtoul(argv[3], NULL, 10); }
+    if(payload_size == 0 || payload_size > sizeof(request)) { payload_size = 256; }
+
+    for(size_t i = 0; i < sizeof(request); i++) {
+        request[i] = (uint8_t)i;
+    }
+
+    //  Sessions
+    isotp_timer_heap_init(&timer_heap, timer_slots, 2);
+
+    setup_session(&tester, tester_tx_buffer, sizeof(tester_tx_buffer), tester_rx_buffer, sizeof(tester_rx_buffer));
+    tester.callback_transmission_rx = tester_rx;
+
+    setup_session(&ecu, ecu_tx_buffer, sizeof(ecu_tx_buffer), ecu_rx_buffer, sizeof(ecu_rx_buffer));
+    ecu.callback_transmission_rx = ecu_rx;
+    ecu.protocol_config.fc_default_request_size = 8;
+    ecu.protocol_config.fc_default_separation_time = 2000;
+
+    //  Routing
+    isotp_router_init(&tester_router, tester_entries, 4);
+    isotp_router_add(&tester_router, &tester, ECU_TX_ID, TESTER_TX_ID);
+
+    isotp_router_init(&ecu_router, ecu_entries, 4);
+    isotp_router_add(&ecu_router, &ecu, TESTER_TX_ID, ECU_TX_ID);
+
+    //  Sockets & loop
+    if(!isotp_socketcan_open(&tester_iface, ifname, &tester_router, false, tester_filters, 4) ||
+       !isotp_socketcan_open(&ecu_iface, ifname, &ecu_router, false, ecu_filters, 4)) {
+        perror("[ERR] Unable to open CAN socket");
+        return 1;
+    }
+
+    isotp_socketcan_loop_t loop;
+    if(!isotp_socketcan_loop_init(&loop, &timer_heap)) {
+        perror("[ERR] Unable to create event loop");
+        return 1;
+    }
+
+    isotp_socketcan_loop_add(&loop, &tester_iface);
+    isotp_socketcan_loop_add(&loop, &ecu_iface);
+
+    //  First request, the loop picks it up on its first pass
+    awaiting_echo = isotp_session_send(&tester, request, payload_size) > 0;
+
+    while(awaiting_echo) {
+        if(isotp_socketcan_loop_run_once(&loop, 1000) < 0) {
+            perror("[ERR] Event loop");
+            break;
+        }
+    }
+
+    isotp_socketcan_loop_close(&loop);
+    isotp_socketcan_close(&tester_iface);
+    isotp_socketcan_close(&ecu_iface);
+
+    return 0;
+}
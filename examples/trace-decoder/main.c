@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <isotp_trace.h>
+
+/*
+    ISOTPlib trace decoder
+
+    Turns a dump of trace events (the raw `isotp_trace_event_t` array drained with `isotp_trace_drain` and written
+    as-is, e.g. fwrite on a host or a memory dump from a target of the same byte order) into a candump-style
+    text timeline, one line per event.
+
+    Usage: trace-decoder [dump file]    (reads stdin when no file is given)
+
+    Timestamps are unwrapped from the 32 bit values stored in each event, so gaps longer than ~71 minutes
+    between two events are not accounted for.
+*/
+
+static const char* state_name(const uint8_t state) {
+    switch(state) {
+        case ISOTP_SESSION_IDLE: return "IDLE";
+        case ISOTP_SESSION_TRANSMITTING: return "TRANSMITTING";
+        case ISOTP_SESSION_TRANSMITTING_AWAITING_FC: return "AWAITING_FC";
+        case ISOTP_SESSION_RECEIVING: return "RECEIVING";
+        case ISOTP_SESSION_RECEIVED: return "RECEIVED";
+        default: return "?";
+    }
+}
+
+static const char* fc_flag_name(const uint8_t flag) {
+    switch(flag) {
+        case ISOTP_SPEC_FC_FLAG_CONTINUE_TO_SEND: return "CTS";
+        case ISOTP_SPEC_FC_FLAG_WAIT: return "WAIT";
+        case ISOTP_SPEC_FC_FLAG_OVERFLOW_ABORT: return "OVFL";
+        default: return "?";
+    }
+}
+
+static const char* timer_name(const uint8_t timer) {
+    switch(timer) {
+        case ISOTP_SESSION_TIMER_N_AS: return "N_As";
+        case ISOTP_SESSION_TIMER_N_BS: return "N_Bs";
+        case ISOTP_SESSION_TIMER_N_CR: return "N_Cr";
+        default: return "?";
+    }
+}
+
+static uint32_t read_u32(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void print_bytes(const uint8_t* data, const size_t length) {
+    for(size_t i = 0; i < length; i++) {
+        printf(" %02X", data[i]);
+    }
+}
+
+static void print_event(const isotp_trace_event_t* event, const uint64_t time_uS) {
+    printf("(%06llu.%06llu)  s%-5u ", (unsigned long long)(time_uS / 1000000), (unsigned long long)(time_uS % 1000000), (unsigned)event->session_id);
+
+    switch(event->type) {
+        case ISOTP_TRACE_FRAME_RX:
+        case ISOTP_TRACE_FRAME_TX: {
+            //  Frame, only the first 8 bytes are recorded
+            const size_t shown = (event->arg < sizeof(event->data)) ? event->arg : sizeof(event->data);
+            printf("%s  [%u] ", (event->type == ISOTP_TRACE_FRAME_RX) ? "RX" : "TX", (unsigned)event->arg);
+            print_bytes(event->data, shown);
+            if(event->arg > shown) { printf(" .."); }
+            break;
+        }
+        case ISOTP_TRACE_FC_RX:
+        case ISOTP_TRACE_FC_TX:
+            printf("%s  %s bs=%u st=%luus", (event->type == ISOTP_TRACE_FC_RX) ? "FC-RX" : "FC-TX", fc_flag_name(event->arg), (unsigned)event->data[0], (unsigned long)read_u32(event->data + 1));
+            break;
+        case ISOTP_TRACE_STATE:
+            printf("STATE  %s -> %s", state_name(event->data[0]), state_name(event->arg));
+            break;
+        case ISOTP_TRACE_ERROR:
+            printf("ERROR  ");
+            switch(event->arg) {
+                case ISOTP_TRACE_ERROR_INVALID_FRAME: printf("invalid frame:"); print_bytes(event->data, sizeof(event->data)); break;
+                case ISOTP_TRACE_ERROR_UNEXPECTED_FRAME: printf("unexpected frame:"); print_bytes(event->data, sizeof(event->data)); break;
+                case ISOTP_TRACE_ERROR_OUT_OF_ORDER: printf("out of order, expected %u got %u", (unsigned)event->data[0], (unsigned)event->data[1]); break;
+                case ISOTP_TRACE_ERROR_TOO_LARGE: printf("too large, %lu bytes", (unsigned long)read_u32(event->data)); break;
+                case ISOTP_TRACE_ERROR_PARTNER_ABORTED: printf("partner aborted:"); print_bytes(event->data, sizeof(event->data)); break;
+                case ISOTP_TRACE_ERROR_TIMEOUT: printf("timeout %s", timer_name(event->data[0])); break;
+                case ISOTP_TRACE_ERROR_FC_OVERFLOW: printf("reception abandoned with FC overflow"); break;
+                case ISOTP_TRACE_ERROR_RX_BUSY: printf("dropped, RX buffer held:"); print_bytes(event->data, sizeof(event->data)); break;
+                default: printf("unknown error %u", (unsigned)event->arg); break;
+            }
+            break;
+        default:
+            printf("UNKNOWN  type=%u arg=%u", (unsigned)event->type, (unsigned)event->arg);
+            break;
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    FILE* input = stdin;
+    if(argc > 1) {
+        input = fopen(argv[1], "rb");
+        if(input == NULL) {
+            perror("[ERR] Unable to open dump");
+            return 1;
+        }
+    }
+
+    //  Unwrap 32 bit timestamps relative to the first event
+    isotp_trace_event_t event;
+    uint64_t time_uS = 0;
+    uint32_t last_timestamp = 0;
+    bool first = true;
+    size_t count = 0;
+
+    while(fread(&event, sizeof(event), 1, input) == 1) {
+        if(!first) {
+            time_uS += (uint32_t)(event.timestamp_uS - last_timestamp);
+        }
+
+        first = false;
+        last_timestamp = event.timestamp_uS;
+        print_event(&event, time_uS);
+        count++;
+    }
+
+    if(input != stdin) { fclose(input); }
+
+    fprintf(stderr, "%zu events\n", count);
+    return 0;
+}
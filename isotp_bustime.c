@@ -0,0 +1,334 @@
+#include "isotp_bustime.h"
+#include "isotp_specification.h"
+#include "isotp_conversions.h"
+
+//  Classic CAN frame bits: SOF, identifier, RTR/SRR, IDE, reserved, DLC & CRC are stuffed
+#define BUSTIME_CLASSIC_STUFFED_BITS_STD 34
+#define BUSTIME_CLASSIC_STUFFED_BITS_EXT 54
+
+//  CRC delimiter, ACK slot & delimiter, EOF and interframe space
+#define BUSTIME_CLASSIC_TAIL_BITS 13
+
+//  CAN FD arbitration phase: SOF, identifier, RRS/SRR, IDE, FDF, reserved & BRS
+#define BUSTIME_FD_ARBITRATION_BITS_STD 17
+#define BUSTIME_FD_ARBITRATION_BITS_EXT 36
+
+//  CAN FD data phase: ESI & DLC ahead of the data
+#define BUSTIME_FD_CONTROL_BITS 5
+
+//  CAN FD stuff count, CRC and their fixed stuff bits (CRC-17 up to 16 data bytes, CRC-21 past), then the CRC delimiter
+#define BUSTIME_FD_CRC17_BITS (4 + 17 + 6 + 1)
+#define BUSTIME_FD_CRC21_BITS (4 + 21 + 7 + 1)
+#define BUSTIME_FD_CRC17_MAX_LEN 16
+
+//  ACK slot & delimiter, EOF and interframe space (nominal bit rate)
+#define BUSTIME_FD_TAIL_BITS 12
+
+//  Stuff bits: worst case one per 4 bits after the first, random data about one per 30
+#define BUSTIME_STUFF_WORST_PERIOD 4
+#define BUSTIME_STUFF_AVG_PERIOD 30
+
+#define BUSTIME_NS_PER_S 1000000000ULL
+#define BUSTIME_NS_PER_US 1000ULL
+
+//  Wire lengths of every frame of a message, as `isotp_session_can_tx` builds them
+typedef struct {
+    bool fd;
+    size_t first_length;                //  Single or first frame
+    bool single;
+    size_t consecutive_frames;
+    size_t consecutive_length;          //  All consecutive frames but the last
+    size_t consecutive_tail_length;     //  Last consecutive frame
+    size_t fc_length;
+    size_t block_size;                  //  Frames per flow control (0 = all)
+    uint64_t separation_nS;             //  Normalized STmin
+} bustime_layout_t;
+
+//  Receiver timeline
+typedef struct {
+    uint64_t done_nS;                   //  Receiver finished the last frame that arrived
+    uint64_t starts_nS[ISOTP_BUSTIME_FIFO_MAX]; //  Processing start of the most recent frames
+    size_t frames;
+    bool overrun;
+} bustime_receiver_t;
+
+static uint64_t bits_nS(const uint64_t bits, const uint32_t bitrate) {
+    return (bits * BUSTIME_NS_PER_S + bitrate - 1) / bitrate;
+}
+
+static uint64_t stuff_bits(const uint64_t bits, const bool worst_case) {
+    if(worst_case) {
+        return (bits > 0) ? (bits - 1) / BUSTIME_STUFF_WORST_PERIOD : 0;
+    }
+
+    return bits / BUSTIME_STUFF_AVG_PERIOD;
+}
+
+uint64_t isotp_bustime_frame_nS(const isotp_bustime_link_t* link, const bool fd, const size_t data_length, const bool worst_case) {
+    //  Safety
+    if(link == NULL || link->nominal_bitrate == 0) {
+        return 0;
+    }
+
+    if(!fd) {
+        const uint64_t stuffed = (link->extended_id ? BUSTIME_CLASSIC_STUFFED_BITS_EXT : BUSTIME_CLASSIC_STUFFED_BITS_STD) + 8 * (uint64_t)data_length;
+        return bits_nS(stuffed + stuff_bits(stuffed, worst_case) + BUSTIME_CLASSIC_TAIL_BITS, link->nominal_bitrate);
+    }
+
+    //  Arbitration & tail at the nominal bit rate
+    const uint64_t arbitration = link->extended_id ? BUSTIME_FD_ARBITRATION_BITS_EXT : BUSTIME_FD_ARBITRATION_BITS_STD;
+    const uint64_t nominal_bits = arbitration + stuff_bits(arbitration, worst_case) + BUSTIME_FD_TAIL_BITS;
+
+    //  Control, data & CRC at the data bit rate (if switched)
+    const uint64_t data = BUSTIME_FD_CONTROL_BITS + 8 * (uint64_t)data_length;
+    const uint64_t data_bits = data + stuff_bits(data, worst_case) + ((data_length <= BUSTIME_FD_CRC17_MAX_LEN) ? BUSTIME_FD_CRC17_BITS : BUSTIME_FD_CRC21_BITS);
+    const uint32_t data_bitrate = (link->data_bitrate != 0) ? link->data_bitrate : link->nominal_bitrate;
+
+    return bits_nS(nominal_bits, link->nominal_bitrate) + bits_nS(data_bits, data_bitrate);
+}
+
+//  Padding of `tx_finalize_frame`
+static size_t bustime_padded(const isotp_session_protocol_config_t* config, const size_t frame_length, const size_t frame_size) {
+    size_t padded_length = config->padding_enabled ? frame_size : frame_length;
+    if(config->frame_format == ISOTP_FORMAT_FD) {
+        if(frame_length > ISOTP_SPEC_FD_DLC_CLASSIC_MAX) {
+            padded_length = isotp_spec_fd_frame_length(frame_length);
+        }
+        else if(config->padding_enabled) {
+            padded_length = ISOTP_SPEC_FD_DLC_CLASSIC_MAX;
+        }
+
+        if(padded_length > frame_size) {
+            padded_length = frame_size;
+        }
+    }
+
+    return padded_length;
+}
+
+static bool bustime_layout(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* config, const size_t payload_length, bustime_layout_t* layout) {
+    const bool fd = (config->frame_format == ISOTP_FORMAT_FD);
+    const size_t address_offset = (config->addressing_mode != ISOTP_ADDRESSING_NORMAL) ? ISOTP_SPEC_FRAME_ADDRESS_LEN : 0;
+
+    //  Frame sizes the format can carry
+    if(config->frame_format == ISOTP_FORMAT_LIN || link->frame_size > (fd ? ISOTP_SPEC_FD_LEN_MAX : ISOTP_SPEC_FD_DLC_CLASSIC_MAX) ||
+       link->frame_size <= address_offset + ISOTP_SPEC_FRAME_FIRST_FD_DATASTART_IDX) {
+        return false;
+    }
+
+    //  12 bit first frame length
+    if(!fd && payload_length > ISOTP_SPEC_FRAME_FIRST_FD_ENABLE_LEN) {
+        return false;
+    }
+
+    //  Frame size of this message (see `tx_transmitting`)
+    size_t frame_size = link->frame_size - address_offset;
+    if(fd && config->fd_tx_dl_planned) {
+        const size_t planned = isotp_spec_fd_plan_frame_size(payload_length, link->frame_size, address_offset, config->fd_header_force, config->padding_enabled, ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES) - address_offset;
+        if(planned < frame_size) {
+            frame_size = planned;
+        }
+    }
+
+    layout->fd = fd;
+    layout->fc_length = bustime_padded(config, address_offset + ISOTP_SPEC_FRAME_FLOWCONTROL_HEADER_END, link->frame_size);
+    layout->block_size = (config->fc_default_request_size > ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK) ? ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK : config->fc_default_request_size;
+    layout->separation_nS = isotp_spec_fc_separation_time_us(isotp_spec_fc_separation_time_byte(config->fc_default_separation_time)) * BUSTIME_NS_PER_US;
+
+    //  Single frame
+    const bool use_fd_header = config->fd_header_force || payload_length >= ISOTP_SPEC_FRAME_SINGLE_FD_ENABLE_LEN - address_offset;
+    const size_t single_available = frame_size - (use_fd_header ? ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX : ISOTP_SPEC_FRAME_SINGLE_DATASTART_IDX);
+    if(payload_length <= single_available) {
+        const size_t header = (fd && use_fd_header) ? ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX : ISOTP_SPEC_FRAME_SINGLE_DATASTART_IDX;
+        layout->single = true;
+        layout->first_length = bustime_padded(config, address_offset + header + payload_length, link->frame_size);
+        layout->consecutive_frames = 0;
+        layout->consecutive_length = 0;
+        layout->consecutive_tail_length = 0;
+        return true;
+    }
+
+    //  First frame, then consecutive frames
+    const size_t first_header = (fd && (config->fd_header_force || payload_length >= ISOTP_SPEC_FRAME_FIRST_FD_ENABLE_LEN)) ? ISOTP_SPEC_FRAME_FIRST_FD_DATASTART_IDX : ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX;
+    const size_t consecutive_payload = frame_size - ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
+    const size_t remaining = payload_length - (frame_size - first_header);
+
+    layout->single = false;
+    layout->first_length = bustime_padded(config, address_offset + frame_size, link->frame_size);
+    layout->consecutive_frames = (remaining + consecutive_payload - 1) / consecutive_payload;
+    layout->consecutive_length = bustime_padded(config, address_offset + frame_size, link->frame_size);
+    layout->consecutive_tail_length = bustime_padded(config, address_offset + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX +
+                                                     remaining - (layout->consecutive_frames - 1) * consecutive_payload, link->frame_size);
+
+    return true;
+}
+
+//  Frame arrives complete at the receiver
+static void bustime_arrive(const isotp_bustime_link_t* link, bustime_receiver_t* receiver, const uint64_t arrival_nS) {
+    const uint64_t start_nS = (receiver->done_nS > arrival_nS) ? receiver->done_nS : arrival_nS;
+
+    //  The FIFO overflows once more frames wait than it holds
+    size_t fifo = link->rx_fifo_frames;
+    if(fifo > ISOTP_BUSTIME_FIFO_MAX) {
+        fifo = ISOTP_BUSTIME_FIFO_MAX;
+    }
+
+    if(fifo != 0 && receiver->frames >= fifo && receiver->starts_nS[(receiver->frames - fifo) % ISOTP_BUSTIME_FIFO_MAX] > arrival_nS) {
+        receiver->overrun = true;
+    }
+
+    receiver->starts_nS[receiver->frames % ISOTP_BUSTIME_FIFO_MAX] = start_nS;
+    receiver->frames++;
+    receiver->done_nS = start_nS + (uint64_t)link->rx_frame_uS * BUSTIME_NS_PER_US;
+}
+
+//  Plays the message through sender, bus and receiver. Returns the latency in nS.
+static uint64_t bustime_simulate(const isotp_bustime_link_t* link, const bustime_layout_t* layout, const bool worst_case, uint64_t* bus_nS, bool* overrun) {
+    bustime_receiver_t receiver;
+    receiver.done_nS = 0;
+    receiver.frames = 0;
+    receiver.overrun = false;
+
+    const uint64_t response_nS = (uint64_t)link->response_uS * BUSTIME_NS_PER_US;
+    const uint64_t gap_nS = (uint64_t)link->frame_gap_uS * BUSTIME_NS_PER_US;
+    const uint64_t consecutive_nS = isotp_bustime_frame_nS(link, layout->fd, layout->consecutive_length, worst_case);
+    const uint64_t tail_nS = isotp_bustime_frame_nS(link, layout->fd, layout->consecutive_tail_length, worst_case);
+    const uint64_t fc_nS = isotp_bustime_frame_nS(link, layout->fd, layout->fc_length, worst_case);
+
+    //  Single or first frame
+    uint64_t busy_nS = isotp_bustime_frame_nS(link, layout->fd, layout->first_length, worst_case);
+    bustime_arrive(link, &receiver, busy_nS);
+
+    size_t remaining = layout->consecutive_frames;
+    while(remaining > 0) {
+        //  Flow control once the receiver processed the block, sender resumes after it
+        const uint64_t fc_end_nS = receiver.done_nS + response_nS + fc_nS;
+        busy_nS += fc_nS;
+
+        const size_t block = (layout->block_size == 0 || layout->block_size > remaining) ? remaining : layout->block_size;
+        uint64_t start_nS = fc_end_nS + response_nS;
+        uint64_t end_nS = 0;
+        for(size_t i = 0; i < block; i++) {
+            //  STmin paces frame starts (as `isotp_session_next_tx_due`), the sender also needs its frame gap
+            if(i > 0) {
+                const uint64_t paced_nS = start_nS + layout->separation_nS;
+                const uint64_t gapped_nS = end_nS + gap_nS;
+                start_nS = (paced_nS > gapped_nS) ? paced_nS : gapped_nS;
+            }
+
+            const uint64_t frame_nS = (remaining - i == 1) ? tail_nS : consecutive_nS;
+            end_nS = start_nS + frame_nS;
+            busy_nS += frame_nS;
+            bustime_arrive(link, &receiver, end_nS);
+        }
+
+        remaining -= block;
+    }
+
+    *bus_nS = busy_nS;
+    *overrun = receiver.overrun;
+    return receiver.done_nS;
+}
+
+static uint32_t bustime_clamp_u32(const uint64_t value) {
+    return (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+}
+
+bool isotp_bustime_estimate(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* config, const size_t payload_length, isotp_bustime_estimate_t* estimate) {
+    //  Safety
+    if(link == NULL || config == NULL || estimate == NULL || link->nominal_bitrate == 0 || payload_length == 0) {
+        return false;
+    }
+
+    bustime_layout_t layout;
+    if(!bustime_layout(link, config, payload_length, &layout)) {
+        return false;
+    }
+
+    //  Frames
+    const size_t consecutive_frames = layout.consecutive_frames;
+    const size_t block_size = (layout.block_size == 0) ? consecutive_frames : layout.block_size;
+    estimate->data_frames = 1 + consecutive_frames;
+    estimate->fc_frames = (consecutive_frames == 0) ? 0 : (consecutive_frames + block_size - 1) / block_size;
+    estimate->bytes_on_wire = layout.first_length + estimate->fc_frames * layout.fc_length;
+    if(consecutive_frames > 0) {
+        estimate->bytes_on_wire += (consecutive_frames - 1) * layout.consecutive_length + layout.consecutive_tail_length;
+    }
+
+    //  Timelines
+    bool overrun_avg = false;
+    bool overrun_worst = false;
+    const uint64_t latency_avg_nS = bustime_simulate(link, &layout, false, &estimate->bus_time_avg_nS, &overrun_avg);
+    const uint64_t latency_worst_nS = bustime_simulate(link, &layout, true, &estimate->bus_time_worst_nS, &overrun_worst);
+
+    estimate->latency_avg_uS = bustime_clamp_u32((latency_avg_nS + BUSTIME_NS_PER_US - 1) / BUSTIME_NS_PER_US);
+    estimate->latency_worst_uS = bustime_clamp_u32((latency_worst_nS + BUSTIME_NS_PER_US - 1) / BUSTIME_NS_PER_US);
+    estimate->throughput_avg_Bps = bustime_clamp_u32((uint64_t)payload_length * BUSTIME_NS_PER_S / latency_avg_nS);
+    estimate->throughput_worst_Bps = bustime_clamp_u32((uint64_t)payload_length * BUSTIME_NS_PER_S / latency_worst_nS);
+    estimate->bus_load_permille = (uint16_t)((estimate->bus_time_avg_nS * 1000) / latency_avg_nS);
+    estimate->rx_overrun = overrun_avg || overrun_worst;
+
+    return true;
+}
+
+//  Smallest valid separation time of at least `uS`
+static uint32_t bustime_separation_covering(const uint32_t uS) {
+    const uint32_t us_max = (ISOTP_SPEC_FC_SEPERATION_TIME_uS_MAX - ISOTP_SPEC_FC_SEPERATION_TIME_uS_MIN + 1) * ISOTP_SPEC_FC_SEPERATION_TIME_uS_SCALAR;
+    const uint32_t ms_max = ISOTP_SPEC_FC_SEPERATION_TIME_MS_MAX * ISOTP_SPEC_FC_SEPERATION_TIME_MS_SCALAR;
+
+    if(uS == 0) {
+        return 0;
+    }
+    else if(uS <= us_max) {
+        return ((uS + ISOTP_SPEC_FC_SEPERATION_TIME_uS_SCALAR - 1) / ISOTP_SPEC_FC_SEPERATION_TIME_uS_SCALAR) * ISOTP_SPEC_FC_SEPERATION_TIME_uS_SCALAR;
+    }
+    else if(uS <= ms_max) {
+        return ((uS + ISOTP_SPEC_FC_SEPERATION_TIME_MS_SCALAR - 1) / ISOTP_SPEC_FC_SEPERATION_TIME_MS_SCALAR) * ISOTP_SPEC_FC_SEPERATION_TIME_MS_SCALAR;
+    }
+
+    return ms_max;
+}
+
+bool isotp_bustime_recommend(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* base, const size_t payload_length, isotp_session_protocol_config_t* recommended, isotp_bustime_estimate_t* estimate) {
+    //  Safety
+    if(link == NULL || base == NULL || recommended == NULL) {
+        return false;
+    }
+
+    //  Candidates, the base values first so ties keep them
+    const size_t block_sizes[] = { base->fc_default_request_size, 0, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint32_t separations[] = { base->fc_default_separation_time, 0, bustime_separation_covering(link->rx_frame_uS) };
+    const bool plans[] = { base->fd_tx_dl_planned, !base->fd_tx_dl_planned };
+    const size_t plan_count = (base->frame_format == ISOTP_FORMAT_FD) ? 2 : 1;
+
+    bool found = false;
+    isotp_bustime_estimate_t best;
+    for(size_t p = 0; p < plan_count; p++) {
+        for(size_t s = 0; s < sizeof(separations) / sizeof(separations[0]); s++) {
+            for(size_t b = 0; b < sizeof(block_sizes) / sizeof(block_sizes[0]); b++) {
+                isotp_session_protocol_config_t candidate = *base;
+                candidate.fd_tx_dl_planned = plans[p];
+                candidate.fc_default_separation_time = separations[s];
+                candidate.fc_default_request_size = block_sizes[b];
+
+                isotp_bustime_estimate_t result;
+                if(!isotp_bustime_estimate(link, &candidate, payload_length, &result) || result.rx_overrun) {
+                    continue;
+                }
+
+                if(!found || result.latency_avg_uS < best.latency_avg_uS ||
+                   (result.latency_avg_uS == best.latency_avg_uS && result.fc_frames < best.fc_frames)) {
+                    found = true;
+                    best = result;
+                    *recommended = candidate;
+                }
+            }
+        }
+    }
+
+    if(found && estimate != NULL) {
+        *estimate = best;
+    }
+
+    return found;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+    ISO-TP Bus Time Model
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Predicts how long a message takes on a CAN or CAN FD bus for a session configuration, without a bus: frames are
+    laid out exactly as `isotp_session_can_tx` builds them (single/first/consecutive split, addressing, padding and
+    the CAN FD data length steps), timed bit by bit at the nominal and data phase bit rates, and played through a
+    sender/receiver timeline with flow control round trips, block size and separation time.
+
+    Every frame is timed twice: with the average bit stuffing of random data, and with the worst case stuffing.
+    `isotp_bustime_recommend` searches block size, separation time and TX_DL planning for the configuration with the
+    lowest latency that does not overrun the receiver. Integer math only, so it may run on the target itself.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+
+//  Most receive FIFO frames modeled (larger FIFOs are modeled as this size)
+#define ISOTP_BUSTIME_FIFO_MAX 64
+
+//  Bus & nodes
+typedef struct {
+	uint32_t nominal_bitrate;				//  Arbitration (and classic CAN) bit rate in bit/s
+	uint32_t data_bitrate;					//  CAN FD data phase bit rate in bit/s (0 = no bit rate switch)
+	bool extended_id;						//  29 bit identifiers
+	size_t frame_size;						//  Frame size passed to `isotp_session_can_tx` (8 = classic CAN, up to 64 for CAN FD)
+
+	uint32_t frame_gap_uS;					//  Least time the sender leaves between the end of one frame and the start of the next (driver & scheduling)
+	uint32_t response_uS;					//  Time a node takes to answer a frame: receiver sending flow control, sender resuming after it
+	uint32_t rx_frame_uS;					//  Time the receiver spends processing each frame (0 = instant)
+	size_t rx_fifo_frames;					//  Frames the receiver can buffer while busy (0 = unlimited)
+} isotp_bustime_link_t;
+
+//  Prediction for one message
+typedef struct {
+	size_t data_frames;						//  Single, first and consecutive frames
+	size_t fc_frames;						//  Flow control frames
+	size_t bytes_on_wire;					//  Data bytes of all frames, including headers, address bytes and padding
+
+	uint64_t bus_time_avg_nS;				//  Time the bus is occupied by the message's frames (average stuffing)
+	uint64_t bus_time_worst_nS;				//  Time the bus is occupied by the message's frames (worst case stuffing)
+	uint32_t latency_avg_uS;				//  Start of the first frame until the receiver processed the last (average stuffing)
+	uint32_t latency_worst_uS;				//  Start of the first frame until the receiver processed the last (worst case stuffing)
+	uint32_t throughput_avg_Bps;			//  Payload bytes per second over `latency_avg_uS`
+	uint32_t throughput_worst_Bps;			//  Payload bytes per second over `latency_worst_uS`
+	uint16_t bus_load_permille;				//  Share of the average latency the bus is occupied (1000 = saturated)
+	bool rx_overrun;						//  Frames arrive faster than the receiver processes them and its FIFO overflows
+} isotp_bustime_estimate_t;
+
+/**
+ * @brief Time a frame occupies the bus, including interframe space
+ *
+ * @param link Bus (bit rates and identifier length)
+ * @param fd CAN FD frame (bit rate switched when `data_bitrate` is set)
+ * @param data_length Data bytes on the wire (0-8 classic, a CAN FD length step up to 64)
+ * @param worst_case Worst case bit stuffing instead of the average of random data
+ * @return uint64_t Frame time in nS (0 = no nominal bit rate)
+ */
+uint64_t isotp_bustime_frame_nS(const isotp_bustime_link_t* link, const bool fd, const size_t data_length, const bool worst_case);
+
+/**
+ * @brief Predicts on-wire time, latency and throughput of one message sent by a session with `config` to a receiver
+ * requesting the flow control of `config` (`fc_default_request_size` & `fc_default_separation_time`)
+ *
+ * @param link Bus & nodes
+ * @param config Protocol configuration of both sessions
+ * @param payload_length Message length
+ * @param estimate Outputted prediction
+ * @return true Prediction made
+ * @return false Invalid parameters, LIN format, or a frame size the format cannot use
+ */
+bool isotp_bustime_estimate(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* config, const size_t payload_length, isotp_bustime_estimate_t* estimate);
+
+/**
+ * @brief Searches block size, separation time and (CAN FD) TX_DL planning for the configuration with the lowest average
+ * latency that does not overrun the receiver. Fewer flow control frames break ties. All other fields are kept from `base`.
+ *
+ * @param link Bus & nodes
+ * @param base Configuration to start from
+ * @param payload_length Typical message length
+ * @param recommended Outputted configuration
+ * @param estimate (Optional) Outputted prediction for `recommended`
+ * @return true Configuration found
+ * @return false Invalid parameters, or every candidate overruns the receiver
+ */
+bool isotp_bustime_recommend(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* base, const size_t payload_length, isotp_session_protocol_config_t* recommended, isotp_bustime_estimate_t* estimate);
+
+#ifdef __cplusplus
+}
+#endif
@@ -34,4 +34,87 @@ uint8_t isotp_spec_fc_separation_time_byte(uint32_t uS) {
         // Invalid input - return no delay
         return ISOTP_SPEC_FC_SEPERATION_TIME_MS_NONE;
     }
-}
\ No newline at end of file
+}
+
+uint8_t isotp_spec_fd_dlc(size_t length) {
+    if(length <= ISOTP_SPEC_FD_DLC_CLASSIC_MAX) {
+        // DLC is the length
+        return (uint8_t)length;
+    }
+
+    // Smallest step that fits
+    for(uint8_t dlc = ISOTP_SPEC_FD_DLC_CLASSIC_MAX + 1; dlc < ISOTP_SPEC_FD_DLC_MAX; dlc++) {
+        if(isotp_spec_fd_dlc_length(dlc) >= length) {
+            return dlc;
+        }
+    }
+
+    return ISOTP_SPEC_FD_DLC_MAX;
+}
+
+size_t isotp_spec_fd_dlc_length(uint8_t dlc) {
+    static const uint8_t lengths[ISOTP_SPEC_FD_DLC_MAX + 1] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+    if(dlc > ISOTP_SPEC_FD_DLC_MAX) {
+        // Invalid input - largest frame
+        return ISOTP_SPEC_FD_LEN_MAX;
+    }
+
+    return lengths[dlc];
+}
+
+size_t isotp_spec_fd_frame_length(size_t length) {
+    return isotp_spec_fd_dlc_length(isotp_spec_fd_dlc(length));
+}
+
+size_t isotp_spec_fd_plan_frame_size(size_t message_length, size_t max_frame_size, size_t address_offset, bool header_force, bool padding, size_t frame_overhead) {
+    if(max_frame_size > ISOTP_SPEC_FD_LEN_MAX) {
+        max_frame_size = ISOTP_SPEC_FD_LEN_MAX;
+    }
+
+    // Single frames are already only padded to the next step
+    const size_t fd_enable_len = ISOTP_SPEC_FRAME_SINGLE_FD_ENABLE_LEN - address_offset;
+    const size_t single_header = (header_force || message_length >= fd_enable_len) ? ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX : ISOTP_SPEC_FRAME_SINGLE_DATASTART_IDX;
+    if(max_frame_size <= address_offset + single_header || message_length <= max_frame_size - address_offset - single_header) {
+        return max_frame_size;
+    }
+
+    // First frame header grows past the 12 bit length
+    const size_t first_header = (header_force || message_length >= ISOTP_SPEC_FRAME_FIRST_FD_ENABLE_LEN) ? ISOTP_SPEC_FRAME_FIRST_FD_DATASTART_IDX : ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX;
+
+    // Bytes on the wire for every frame size step, ties go to the larger size (fewer frames)
+    size_t best_size = max_frame_size;
+    size_t best_cost = SIZE_MAX;
+    for(uint8_t dlc = ISOTP_SPEC_FD_DLC_CLASSIC_MAX; dlc <= ISOTP_SPEC_FD_DLC_MAX; dlc++) {
+        const size_t size = isotp_spec_fd_dlc_length(dlc);
+        if(size > max_frame_size) {
+            break;
+        }
+
+        // A first frame needs at least one consecutive frame after it
+        if(size <= address_offset + first_header || message_length <= size - address_offset - first_header) {
+            continue;
+        }
+
+        const size_t first_payload = size - address_offset - first_header;
+        const size_t consecutive_payload = size - address_offset - ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
+        const size_t remaining = message_length - first_payload;
+        const size_t consecutive_frames = (remaining + consecutive_payload - 1) / consecutive_payload;
+        const size_t tail = remaining - (consecutive_frames - 1) * consecutive_payload;
+
+        // Full frames, then the tail padded to its step (and to 8 bytes with padding)
+        size_t tail_length = isotp_spec_fd_frame_length(address_offset + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX + tail);
+        if(padding && tail_length < ISOTP_SPEC_FD_DLC_CLASSIC_MAX) {
+            tail_length = ISOTP_SPEC_FD_DLC_CLASSIC_MAX;
+        }
+
+        const size_t cost = consecutive_frames * (size + frame_overhead) + tail_length + frame_overhead;
+
+        if(cost <= best_cost) {
+            best_cost = cost;
+            best_size = size;
+        }
+    }
+
+    return best_size;
+}
@@ -6,6 +6,13 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+//  Approximate bus time of a CAN FD frame beyond its data field (arbitration at the nominal bit rate, CRC, ACK, EOF & IFS), in data bytes
+#ifndef ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES
+#define ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES 16
+#endif
 
 /**
  * @brief Convert FC separation time byte to uS
@@ -23,6 +30,45 @@ uint32_t isotp_spec_fc_separation_time_us(uint8_t req_sep_byte);
  */
 uint8_t isotp_spec_fc_separation_time_byte(uint32_t uS);
 
+/**
+ * @brief Convert a frame length to the smallest CAN FD DLC that carries it
+ * 
+ * @param length Frame length in bytes
+ * @return uint8_t DLC 0-15 (15 for anything over 64 bytes)
+ */
+uint8_t isotp_spec_fd_dlc(size_t length);
+
+/**
+ * @brief Convert a CAN FD DLC to its frame length
+ * 
+ * @param dlc DLC 0-15
+ * @return size_t Frame length in bytes (64 for DLCs over 15)
+ */
+size_t isotp_spec_fd_dlc_length(uint8_t dlc);
+
+/**
+ * @brief Round a frame length up to the next length CAN FD can carry (8, 12, 16, 20, 24, 32, 48 or 64 past 8 bytes)
+ * 
+ * @param length Frame length in bytes
+ * @return size_t Length on the wire (at most 64)
+ */
+size_t isotp_spec_fd_frame_length(size_t length);
+
+/**
+ * @brief Plan the CAN FD frame size (TX_DL) of a message so the fewest bytes go on the wire. Consecutive frames must all
+ * match the first frame except the last, which is only padded to the next data length step. A smaller TX_DL can
+ * therefore avoid a nearly empty tail frame.
+ * 
+ * @param message_length Payload length of the message
+ * @param max_frame_size Largest frame size allowed (the bus TX_DL)
+ * @param address_offset Address bytes prefixed to every frame (0 for normal addressing)
+ * @param header_force CAN FD headers are used even for lengths the classic headers cover (see `fd_header_force`)
+ * @param padding Frames of 8 bytes or less are padded to 8 (see `padding_enabled`)
+ * @param frame_overhead Cost of each frame beyond its data, in bytes (see ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES)
+ * @return size_t Frame size to transmit the message with (`max_frame_size` when it fits a single frame or nothing smaller is cheaper)
+ */
+size_t isotp_spec_fd_plan_frame_size(size_t message_length, size_t max_frame_size, size_t address_offset, bool header_force, bool padding, size_t frame_overhead);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,661 @@
+#pragma once
+
+/*
+    ISO-TP Coroutine Sessions
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Header-only C++20 layer that turns the session callbacks into awaitables, so clients are written as straight-line
+    code instead of hand-written state machines:
+
+        isotp::coro_task<isotp::coro_status> request(isotp::coro_session& session, std::span<const uint8_t> data) {
+            isotp::coro_status status = co_await session.send(data);
+            if(status != isotp::coro_status::ok) { co_return status; }
+
+            isotp::coro_message response = co_await session.receive(50000);
+            co_return response.status;
+        }
+
+    `coro_session` owns an `isotp_session_t` with its callbacks bound to the awaitables. A single-threaded
+    `coro_executor` drives every session registered with it: `poll` expires timers, fetches due frames (the session
+    honors STmin on the executor's clock) and resumes coroutines whose sends or receives ended. Received CAN frames
+    are fed with `coro_session::on_frame`. Nothing here is thread-safe, all calls must come from the executor thread.
+
+    Coroutine frames are allocated from the arena of the `coro_session` passed to the coroutine (any parameter,
+    or the object of a member coroutine), never from the heap: steady-state operation does not allocate. A
+    coroutine whose frame does not fit the arena's blocks fails to start (see `coro_task::valid`).
+    This header is not part of `isotplib.cpp`, include it directly and build with -std=c++20.
+*/
+
+#ifndef __cplusplus
+#error "isotp_coro.hpp is designed to work in C++ environments only."
+#endif
+
+#if !defined(__cpp_impl_coroutine)
+#error "isotp_coro.hpp requires C++20 coroutines (-std=c++20)."
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <coroutine>
+#include <exception>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "isotp_session.h"
+
+namespace isotp {
+
+//  Frames fetched per session per `coro_executor::poll`, so one transfer cannot starve the others
+#ifndef ISOTP_CORO_POLL_FRAMES
+#define ISOTP_CORO_POLL_FRAMES 16
+#endif
+
+//  How an awaited send or receive ended
+enum class coro_status : uint8_t {
+    ok = 0,
+    timeout,                //  N_As/N_Bs/N_Cr expired, or `receive` waited past its timeout
+    aborted,                //  Transfer abandoned (partner sent FC overflow, the session was idled, or a send replaced a half duplex reception)
+    busy,                   //  A send is already in progress on the session
+    too_large,              //  Message does not fit the RX buffer
+    out_of_order,           //  Consecutive frame index out of order
+    invalid,                //  Empty message or coroutine frame not allocated
+};
+
+//  Recieved message. `data` points into the session's RX buffer and is valid until the session recieves its next
+//  frame, copy it or use receive slots (`isotp_session_use_rx_slots`, then `isotp_session_release_rx`) to keep it longer.
+struct coro_message {
+    coro_status status = coro_status::invalid;
+    std::span<const uint8_t> data;
+};
+
+class coro_session;
+class coro_executor;
+
+//  Fixed block allocator for coroutine frames (single-threaded)
+class coro_arena {
+public:
+    /**
+     * @brief Arena over user provided storage, `block_size * block_count` bytes aligned for `max_align_t`
+     */
+    coro_arena(void* storage, const size_t block_size, const size_t block_count) : free_(nullptr), block_size_(block_size), in_use_(0), high_water_(0), failures_(0) {
+        //  Chain every block onto the free list
+        uint8_t* block = static_cast<uint8_t*>(storage);
+        for(size_t i = 0; storage != nullptr && block_size >= sizeof(void*) && i < block_count; i++) {
+            *reinterpret_cast<void**>(block + (block_count - 1 - i) * block_size) = free_;
+            free_ = block + (block_count - 1 - i) * block_size;
+        }
+    }
+
+    coro_arena(const coro_arena&) = delete;
+    coro_arena& operator=(const coro_arena&) = delete;
+
+    /**
+     * @brief Takes a block for `size` bytes (nullptr = larger than a block, or no block free)
+     */
+    void* allocate(const size_t size) noexcept {
+        if(size > block_size_ || free_ == nullptr) {
+            failures_++;
+            return nullptr;
+        }
+
+        void* block = free_;
+        free_ = *static_cast<void**>(block);
+        if(++in_use_ > high_water_) { high_water_ = in_use_; }
+        return block;
+    }
+
+    /**
+     * @brief Returns a block taken with `allocate`
+     */
+    void deallocate(void* block) noexcept {
+        *static_cast<void**>(block) = free_;
+        free_ = block;
+        in_use_--;
+    }
+
+    size_t block_size() const { return block_size_; }
+    size_t in_use() const { return in_use_; }                 //  Blocks allocated
+    size_t high_water() const { return high_water_; }         //  Most blocks allocated at once
+    size_t failures() const { return failures_; }             //  Allocations refused (frame too large or arena empty)
+
+private:
+    void* free_;
+    size_t block_size_;
+    size_t in_use_;
+    size_t high_water_;
+    size_t failures_;
+};
+
+//  Arena with its own storage
+template <size_t BlockSize, size_t BlockCount>
+class coro_arena_storage : public coro_arena {
+    static_assert(BlockSize % alignof(max_align_t) == 0, "Block size must keep blocks aligned for max_align_t");
+    static_assert(BlockCount > 0, "Arena needs at least one block");
+
+public:
+    coro_arena_storage() : coro_arena(storage_, BlockSize, BlockCount) {}
+
+private:
+    alignas(max_align_t) uint8_t storage_[BlockSize * BlockCount];
+};
+
+template <typename T>
+class coro_task;
+
+namespace detail {
+
+//  Arena a coroutine frame is drawn from: the first `coro_session` among the coroutine's parameters
+template <typename First, typename... Rest>
+coro_arena* coro_arena_of(First& first, Rest&... rest);
+
+//  Frame header, keeps the frame aligned for max_align_t
+struct alignas(max_align_t) coro_frame_header {
+    coro_arena* arena;
+};
+
+class coro_promise_base {
+public:
+    //  Always inlined: GCC pairs a templated `operator new` call with no `operator delete` and warns on every coroutine
+    template <typename... Args>
+    [[gnu::always_inline]] static void* operator new(const size_t size, Args&... args) noexcept {
+        static_assert(sizeof...(Args) > 0, "Coroutines must take an isotp::coro_session& so their frame can come from its arena");
+
+        coro_arena* arena = coro_arena_of(args...);
+        void* block = arena->allocate(size + sizeof(coro_frame_header));
+        if(block == nullptr) {
+            return nullptr;
+        }
+
+        static_cast<coro_frame_header*>(block)->arena = arena;
+        return static_cast<coro_frame_header*>(block) + 1;
+    }
+
+    static void operator delete(void* frame, const size_t) noexcept {
+        coro_frame_header* header = static_cast<coro_frame_header*>(frame) - 1;
+        header->arena->deallocate(header);
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    //  Hands control back to the awaiting coroutine, or frees a detached coroutine's frame
+    struct final_awaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            coro_promise_base& promise = handle.promise();
+            if(promise.continuation_) {
+                return promise.continuation_;
+            }
+
+            if(promise.detached_) {
+                handle.destroy();
+            }
+
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    final_awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    std::coroutine_handle<> continuation_;
+    bool detached_ = false;
+};
+
+template <typename T>
+class coro_promise : public coro_promise_base {
+public:
+    coro_task<T> get_return_object() noexcept;
+    static coro_task<T> get_return_object_on_allocation_failure() noexcept;
+    void return_value(T value) noexcept { value_ = std::move(value); }
+
+    T value_{};
+};
+
+template <>
+class coro_promise<void> : public coro_promise_base {
+public:
+    coro_task<void> get_return_object() noexcept;
+    static coro_task<void> get_return_object_on_allocation_failure() noexcept;
+    void return_void() noexcept {}
+};
+
+}
+
+/**
+ * @brief Lazily started coroutine. `co_await` it from another coroutine, or hand a `coro_task<void>` to
+ * `coro_executor::spawn`. A task that could not allocate its frame is not `valid` and completes at once with `T{}`.
+ */
+template <typename T = void>
+class coro_task {
+public:
+    using promise_type = detail::coro_promise<T>;
+
+    coro_task() noexcept = default;
+    explicit coro_task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+    coro_task(coro_task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    coro_task& operator=(coro_task&& other) noexcept {
+        if(this != &other) {
+            if(handle_) { handle_.destroy(); }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    coro_task(const coro_task&) = delete;
+    coro_task& operator=(const coro_task&) = delete;
+    ~coro_task() { if(handle_) { handle_.destroy(); } }
+
+    bool valid() const { return static_cast<bool>(handle_); }
+
+    //  Awaiting runs the task, and resumes the caller when it completes
+    bool await_ready() const noexcept { return !handle_; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation_ = caller;
+        return handle_;
+    }
+
+    T await_resume() noexcept {
+        if constexpr(!std::is_void_v<T>) {
+            return handle_ ? std::move(handle_.promise().value_) : T{};
+        }
+    }
+
+private:
+    friend class coro_executor;
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+coro_task<T> coro_promise<T>::get_return_object() noexcept { return coro_task<T>(std::coroutine_handle<coro_promise<T>>::from_promise(*this)); }
+template <typename T>
+coro_task<T> coro_promise<T>::get_return_object_on_allocation_failure() noexcept { return coro_task<T>(); }
+inline coro_task<void> coro_promise<void>::get_return_object() noexcept { return coro_task<void>(std::coroutine_handle<coro_promise<void>>::from_promise(*this)); }
+inline coro_task<void> coro_promise<void>::get_return_object_on_allocation_failure() noexcept { return coro_task<void>(); }
+
+}
+
+//  Single-threaded driver of coroutine sessions
+class coro_executor {
+public:
+    /**
+     * @brief Executor on a monotonic clock in uS, also used as the sessions' `callback_time_uS`
+     */
+    explicit coro_executor(uint64_t (*clock_uS)(void* context), void* clock_context = nullptr) : clock_uS_(clock_uS), clock_context_(clock_context), sessions_(nullptr) {}
+
+    coro_executor(const coro_executor&) = delete;
+    coro_executor& operator=(const coro_executor&) = delete;
+
+    uint64_t now_uS() const { return clock_uS_(clock_context_); }
+
+    /**
+     * @brief Starts a task, which runs until its first suspension. Its frame is freed when it completes.
+     *
+     * @return false Task not valid (its frame could not be allocated)
+     */
+    bool spawn(coro_task<void>&& task) {
+        if(!task.valid()) {
+            return false;
+        }
+
+        std::coroutine_handle<detail::coro_promise<void>> handle = std::exchange(task.handle_, {});
+        handle.promise().detached_ = true;
+        handle.resume();
+        return true;
+    }
+
+    /**
+     * @brief Expires timers, transmits due frames and resumes coroutines whose operations ended
+     *
+     * @return uint64_t Time `poll` should next run on the executor's clock (ISOTP_SESSION_DEADLINE_NONE = only once a frame is recieved)
+     */
+    uint64_t poll();
+
+private:
+    friend class coro_session;
+
+    uint64_t (*clock_uS_)(void* context);
+    void* clock_context_;
+    coro_session* sessions_;
+};
+
+//  Session whose sends and receives are awaited (must outlive the coroutines using it, not movable)
+class coro_session {
+public:
+    /**
+     * @brief Session registered with `executor`, frames allocated from `arena`. Received frames are passed to
+     * `on_frame`, frames to send are handed to `transmit` from `coro_executor::poll` (the driver must queue them).
+     */
+    coro_session(coro_executor& executor, coro_arena& arena, const isotp_format_t format, std::span<uint8_t> rx_buffer, const size_t frame_size,
+                 void (*transmit)(void* context, const uint8_t* data, const size_t length), void* transmit_context = nullptr)
+        : executor_(&executor), arena_(&arena), next_(executor.sessions_), frame_size_(frame_size), transmit_(transmit), transmit_context_(transmit_context) {
+        //  Sends are borrowed from the awaiting coroutine, no TX buffer
+        isotp_session_init(&session_, format, nullptr, 0, rx_buffer.data(), rx_buffer.size());
+        isotp_session_use_ops(&session_, &session_ops, nullptr);
+        isotp_session_idle(&session_);
+
+        executor.sessions_ = this;
+    }
+
+    ~coro_session() {
+        for(coro_session** link = &executor_->sessions_; *link != nullptr; link = &(*link)->next_) {
+            if(*link == this) {
+                *link = next_;
+                break;
+            }
+        }
+    }
+
+    coro_session(const coro_session&) = delete;
+    coro_session& operator=(const coro_session&) = delete;
+
+    //  Underlying session, for configuration (`protocol_config`, slots, ...). The `ops` table and context bound by `coro_session` must be kept.
+    isotp_session_t* native() { return &session_; }
+    coro_arena& arena() { return *arena_; }
+
+    //  Messages recieved while no coroutine awaited `receive` and replaced by a newer one
+    size_t dropped() const { return dropped_; }
+
+    /**
+     * @brief Processes a recieved CAN frame, then resumes coroutines whose operations ended
+     */
+    void on_frame(const uint8_t* data, const size_t length) {
+        isotp_session_can_rx(&session_, data, length);
+        resume_ready();
+    }
+
+    //  Awaitable of `send`
+    class send_awaiter {
+    public:
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> caller) noexcept {
+            if(session_->send_waiting_) {
+                status_ = coro_status::busy;
+                return false;
+            }
+
+            //  Zero-copy: the data lives in the suspended caller's frame until the send ends
+            session_->last_error_ = coro_status::ok;
+            const bool receiving = !session_->session_.protocol_config.full_duplex && session_->session_.state == ISOTP_SESSION_RECEIVING;
+            if(isotp_session_send_borrowed(&session_->session_, data_.data(), data_.size()) == 0) {
+                status_ = coro_status::invalid;
+                return false;
+            }
+
+            //  Half duplex: the reception in progress was idled without any callback, end its `receive`
+            if(receiving) {
+                session_->fail_receive(coro_status::aborted);
+            }
+
+            session_->send_waiting_ = caller;
+            session_->send_status_ = &status_;
+            return true;
+        }
+
+        coro_status await_resume() const noexcept { return status_; }
+
+    private:
+        friend class coro_session;
+        send_awaiter(coro_session* session, std::span<const uint8_t> data) : session_(session), data_(data) {}
+
+        coro_session* session_;
+        std::span<const uint8_t> data_;
+        coro_status status_ = coro_status::invalid;
+    };
+
+    //  Awaitable of `receive`
+    class receive_awaiter {
+    public:
+        //  Message that completed while nobody was waiting
+        bool await_ready() noexcept {
+            if(!session_->mailbox_full_) {
+                return false;
+            }
+
+            message_ = session_->mailbox_;
+            session_->mailbox_full_ = false;
+            return true;
+        }
+
+        bool await_suspend(std::coroutine_handle<> caller) noexcept {
+            if(session_->receive_waiting_) {
+                message_.status = coro_status::busy;
+                return false;
+            }
+
+            session_->receive_waiting_ = caller;
+            session_->receive_message_ = &message_;
+            session_->receive_deadline_uS_ = (timeout_uS_ != 0) ? session_->executor_->now_uS() + timeout_uS_ : ISOTP_SESSION_DEADLINE_NONE;
+            return true;
+        }
+
+        coro_message await_resume() const noexcept { return message_; }
+
+    private:
+        friend class coro_session;
+        receive_awaiter(coro_session* session, const uint32_t timeout_uS) : session_(session), timeout_uS_(timeout_uS) {}
+
+        coro_session* session_;
+        uint32_t timeout_uS_;
+        coro_message message_;
+    };
+
+    /**
+     * @brief Sends a message without copying it, resuming once it was fully sent or abandoned. `data` must stay valid
+     * until then, which it does when it lives in the awaiting coroutine.
+     */
+    send_awaiter send(std::span<const uint8_t> data) { return send_awaiter(this, data); }
+
+    /**
+     * @brief Awaits the next recieved message, or a reception error
+     *
+     * @param timeout_uS Longest wait (0 = none)
+     */
+    receive_awaiter receive(const uint32_t timeout_uS = 0) { return receive_awaiter(this, timeout_uS); }
+
+private:
+    friend class coro_executor;
+
+    //  Session callbacks (context is the embedded session, first member)
+    static coro_session* from(void* context) { return reinterpret_cast<coro_session*>(static_cast<isotp_session_t*>(context)); }
+
+    static uint64_t on_time(void* context) { return from(context)->executor_->now_uS(); }
+
+    static void on_transmission_tx(void* context, const bool completed) {
+        coro_session* self = from(context);
+        if(self->send_status_ != nullptr) {
+            *self->send_status_ = completed ? coro_status::ok : ((self->last_error_ != coro_status::ok) ? self->last_error_ : coro_status::aborted);
+            self->send_status_ = nullptr;
+            self->send_ready_ = true;
+        }
+    }
+
+    static void on_transmission_rx(void* context) {
+        coro_session* self = from(context);
+        const coro_message message = { coro_status::ok, std::span<const uint8_t>(static_cast<const uint8_t*>(self->session_.rx_buffer), self->session_.full_transmission_length) };
+        self->deliver(message);
+        isotp_session_idle(&self->session_);
+    }
+
+    static void on_too_large(void* context, const uint8_t*, const size_t, const size_t) {
+        from(context)->fail_receive(coro_status::too_large);
+        isotp_session_idle(static_cast<isotp_session_t*>(context));
+    }
+
+    static void on_out_of_order(void* context, const uint8_t*, const size_t, const uint8_t, const uint8_t) {
+        from(context)->fail_receive(coro_status::out_of_order);
+        isotp_session_idle(static_cast<isotp_session_t*>(context));
+    }
+
+    static void on_partner_aborted(void* context, const uint8_t*, const size_t) {
+        from(context)->last_error_ = coro_status::aborted;
+        isotp_session_idle(static_cast<isotp_session_t*>(context));
+    }
+
+    static void on_timeout(void* context, const isotp_session_timer_t timer) {
+        coro_session* self = from(context);
+        if(timer == ISOTP_SESSION_TIMER_N_CR) {
+            self->fail_receive(coro_status::timeout);
+        }
+        else {
+            self->last_error_ = coro_status::timeout;
+        }
+
+        isotp_session_idle(&self->session_);
+    }
+
+    static void on_invalid_frame(void*, const isotp_spec_frame_type_t, const uint8_t*, const size_t) {}
+    static void on_unexpected_frame(void*, const uint8_t*, const size_t) {}
+
+    //  Callback table shared by every coroutine session
+    static constexpr isotp_session_ops_t session_ops = {
+        .callback_transmission_rx = on_transmission_rx,
+        .callback_error_invalid_frame = on_invalid_frame,
+        .callback_error_partner_aborted_transfer = on_partner_aborted,
+        .callback_error_transmission_too_large = on_too_large,
+        .callback_error_consecutive_out_of_order = on_out_of_order,
+        .callback_error_unexpected_frame_type = on_unexpected_frame,
+        .callback_peek_first_frame = nullptr,
+        .callback_peek_consecutive_frame = nullptr,
+        .callback_peek_flow_control_frame = nullptr,
+        .callback_can_rx = nullptr,
+        .callback_can_tx = nullptr,
+        .callback_mem_assign = nullptr,
+        .callback_transmission_tx = on_transmission_tx,
+        .callback_time_uS = on_time,
+        .callback_error_timeout = on_timeout,
+        .callback_fc_policy = nullptr,
+        .callback_error_rx_busy = nullptr,
+    };
+
+    void deliver(const coro_message& message) {
+        if(receive_message_ != nullptr) {
+            *receive_message_ = message;
+            receive_message_ = nullptr;
+            receive_ready_ = true;
+            return;
+        }
+
+        //  Nobody waiting, keep the newest
+        if(mailbox_full_) { dropped_++; }
+        mailbox_ = message;
+        mailbox_full_ = true;
+    }
+
+    void fail_receive(const coro_status status) {
+        if(receive_message_ != nullptr) {
+            receive_message_->status = status;
+            receive_message_ = nullptr;
+            receive_ready_ = true;
+        }
+    }
+
+    //  Resumed coroutines may await again, so each handle is cleared first
+    void resume_ready() {
+        while(send_ready_ || receive_ready_) {
+            if(send_ready_) {
+                send_ready_ = false;
+                std::exchange(send_waiting_, {}).resume();
+            }
+
+            if(receive_ready_) {
+                receive_ready_ = false;
+                std::exchange(receive_waiting_, {}).resume();
+            }
+        }
+    }
+
+    //  Timers & frames due, returns the next time to poll
+    uint64_t poll(const uint64_t now_uS) {
+        isotp_session_tick(&session_, now_uS);
+
+        if(receive_message_ != nullptr && now_uS >= receive_deadline_uS_) {
+            fail_receive(coro_status::timeout);
+        }
+
+        //  Due frames (the session holds back frames until STmin passed)
+        uint8_t frame[ISOTP_CAN_FRAME_MAX_SIZE];
+        size_t frames = 0;
+        while(frames < ISOTP_CORO_POLL_FRAMES) {
+            const size_t length = isotp_session_can_tx(&session_, frame, frame_size_, nullptr);
+            if(length == 0) {
+                break;
+            }
+
+            transmit_(transmit_context_, frame, length);
+            frames++;
+        }
+
+        resume_ready();
+
+        //  Next wake: a frame due, the session's timer or the receive timeout
+        uint64_t next_uS = (frames == ISOTP_CORO_POLL_FRAMES) ? now_uS : isotp_session_next_tx_due(&session_);
+        if(session_.deadline_uS < next_uS) { next_uS = session_.deadline_uS; }
+        if(receive_message_ != nullptr && receive_deadline_uS_ < next_uS) { next_uS = receive_deadline_uS_; }
+        return next_uS;
+    }
+
+    isotp_session_t session_;                           //  First member, see `from`
+    coro_executor* executor_;
+    coro_arena* arena_;
+    coro_session* next_;                                //  Next session of the executor
+    size_t frame_size_;
+    void (*transmit_)(void* context, const uint8_t* data, const size_t length);
+    void* transmit_context_;
+
+    std::coroutine_handle<> send_waiting_;
+    coro_status* send_status_ = nullptr;
+    bool send_ready_ = false;
+    coro_status last_error_ = coro_status::ok;         //  Reason the transmission in progress is being abandoned
+
+    std::coroutine_handle<> receive_waiting_;
+    coro_message* receive_message_ = nullptr;
+    uint64_t receive_deadline_uS_ = ISOTP_SESSION_DEADLINE_NONE;
+    bool receive_ready_ = false;
+
+    coro_message mailbox_;
+    bool mailbox_full_ = false;
+    size_t dropped_ = 0;
+};
+
+static_assert(std::is_standard_layout_v<coro_session>, "coro_session must stay standard layout so callbacks can map the session back to it");
+
+inline uint64_t coro_executor::poll() {
+    const uint64_t time_uS = now_uS();
+    uint64_t next_uS = ISOTP_SESSION_DEADLINE_NONE;
+
+    for(coro_session* session = sessions_; session != nullptr; session = session->next_) {
+        const uint64_t session_next_uS = session->poll(time_uS);
+        if(session_next_uS < next_uS) { next_uS = session_next_uS; }
+    }
+
+    return next_uS;
+}
+
+namespace detail {
+
+template <typename First, typename... Rest>
+coro_arena* coro_arena_of(First& first, Rest&... rest) {
+    using type = std::remove_cvref_t<First>;
+    if constexpr(std::is_base_of_v<coro_session, type>) {
+        return &first.arena();
+    }
+    else if constexpr(std::is_pointer_v<type> && std::is_base_of_v<coro_session, std::remove_cv_t<std::remove_pointer_t<type>>>) {
+        return &first->arena();
+    }
+    else {
+        static_assert(sizeof...(Rest) > 0, "Coroutines must take an isotp::coro_session& so their frame can come from its arena");
+        return coro_arena_of(rest...);
+    }
+}
+
+}
+
+}
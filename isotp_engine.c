@@ -0,0 +1,362 @@
+#if defined(__linux__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include "isotp_engine.h"
+
+//  Mix identifier bits so sequential IDs (0x7E0, 0x7E1, ...) spread across shards
+static inline size_t engine_hash(const uint32_t id, const size_t count) {
+    uint32_t h = id;
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return (size_t)h % count;
+}
+
+//  Take exclusive ownership of a shard
+static inline bool engine_claim(isotp_engine_shard_t* shard) {
+    bool expected = false;
+    return __atomic_compare_exchange_n(&shard->busy, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline void engine_release(isotp_engine_shard_t* shard) {
+    __atomic_store_n(&shard->busy, false, __ATOMIC_RELEASE);
+}
+
+//  Any shard with recieved frames waiting
+static bool engine_rx_pending(isotp_engine_t* engine) {
+    for(size_t idx = 0; idx < engine->shard_count; idx++) {
+        if(isotp_frame_queue_count(&engine->shards[idx].rx_queue) > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//  Wake idle workers (I/O thread side of the sleep handshake)
+static void engine_wake(isotp_engine_t* engine) {
+    __atomic_add_fetch(&engine->wake_seq, 1, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&engine->sleepers, __ATOMIC_SEQ_CST) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&engine->idle_lock);
+    pthread_cond_broadcast(&engine->idle_cond);
+    pthread_mutex_unlock(&engine->idle_lock);
+}
+
+//  Processes a claimed shard: recieved frames, expired timers, then frames to transmit. Returns recieved frames processed.
+static size_t engine_shard_run(isotp_engine_t* engine, isotp_engine_shard_t* shard, const uint64_t now_uS) {
+    //  Recieve
+    const size_t processed = isotp_frame_queue_pump_router(&shard->rx_queue, &shard->router, ISOTP_ENGINE_BATCH_SIZE);
+    shard->frames_processed += processed;
+
+    //  Timeouts
+    isotp_timer_heap_tick(&shard->timer_heap, now_uS);
+
+    //  Transmit while the I/O thread has room (frames must not be pulled from a session without being queued)
+    size_t queued = 0;
+    while(isotp_frame_queue_count(&shard->tx_queue) <= shard->tx_queue.mask) {
+        isotp_can_frame_t frame;
+        uint32_t identifier = 0;
+        const size_t length = isotp_router_can_tx(&shard->router, &identifier, frame.data, engine->frame_size, NULL);
+        if(length == 0) {
+            break;
+        }
+
+        isotp_frame_queue_push(&shard->tx_queue, identifier, frame.data, length, 0);
+        queued++;
+    }
+
+    //  Callback
+    if(queued > 0 && engine->callback_tx_ready != NULL) { engine->callback_tx_ready(engine->tx_ready_context); }
+
+    return processed;
+}
+
+//  Sleeps until frames are dispatched, the shard's next frame or timer is due, or ISOTP_ENGINE_IDLE_uS passed
+static void engine_idle(isotp_engine_t* engine, isotp_engine_shard_t* shard, const uint64_t now_uS, const size_t seen_seq) {
+    uint64_t wake_uS = now_uS + ISOTP_ENGINE_IDLE_uS;
+
+    //  Own shard deadlines (the shard may be claimed by a thief, it will be rechecked on wakeup)
+    if(engine_claim(shard)) {
+        const uint64_t tx_due = isotp_router_next_tx_due(&shard->router);
+        const uint64_t timer_due = isotp_timer_heap_next_deadline(&shard->timer_heap);
+        engine_release(shard);
+
+        //  Frames due while the TX queue is full wait for the I/O thread, not the clock
+        if(tx_due < wake_uS && isotp_frame_queue_count(&shard->tx_queue) <= shard->tx_queue.mask) { wake_uS = tx_due; }
+        if(timer_due < wake_uS) { wake_uS = timer_due; }
+    }
+
+    if(wake_uS <= now_uS) {
+        return;
+    }
+
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(wake_uS / 1000000ULL);
+    deadline.tv_nsec = (long)((wake_uS % 1000000ULL) * 1000ULL);
+
+    //  Worker side of the sleep handshake, work handed over after the check below always finds `sleepers` set
+    pthread_mutex_lock(&engine->idle_lock);
+    __atomic_add_fetch(&engine->sleepers, 1, __ATOMIC_SEQ_CST);
+
+    if(__atomic_load_n(&engine->running, __ATOMIC_ACQUIRE) && __atomic_load_n(&engine->wake_seq, __ATOMIC_SEQ_CST) == seen_seq && !engine_rx_pending(engine)) {
+        pthread_cond_timedwait(&engine->idle_cond, &engine->idle_lock, &deadline);
+    }
+
+    __atomic_sub_fetch(&engine->sleepers, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&engine->idle_lock);
+}
+
+static void* engine_worker(void* arg) {
+    isotp_engine_shard_t* own = (isotp_engine_shard_t*)arg;
+    isotp_engine_t* engine = own->engine;
+    const size_t own_idx = (size_t)(own - engine->shards);
+
+    while(__atomic_load_n(&engine->running, __ATOMIC_ACQUIRE)) {
+        const size_t seen_seq = __atomic_load_n(&engine->wake_seq, __ATOMIC_SEQ_CST);
+        const uint64_t now_uS = isotp_engine_time_uS(NULL);
+        size_t processed = 0;
+
+        //  Own shard first, then steal recieve backlog from the others
+        for(size_t offset = 0; offset < engine->shard_count; offset++) {
+            isotp_engine_shard_t* shard = &engine->shards[(own_idx + offset) % engine->shard_count];
+            if(offset > 0 && isotp_frame_queue_count(&shard->rx_queue) == 0) {
+                continue;
+            }
+
+            if(!engine_claim(shard)) {
+                continue;
+            }
+
+            const size_t count = engine_shard_run(engine, shard, now_uS);
+            if(offset > 0) { shard->frames_stolen += count; }
+            engine_release(shard);
+
+            processed += count;
+        }
+
+        //  Nothing recieved anywhere
+        if(processed == 0) {
+            engine_idle(engine, own, now_uS, seen_seq);
+        }
+    }
+
+    return NULL;
+}
+
+uint64_t isotp_engine_time_uS(void* context) {
+    (void)context;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+bool isotp_engine_init(isotp_engine_t* engine, isotp_engine_shard_t* shards, const size_t shard_count, const size_t frame_size) {
+    //  Safety
+    if(engine == NULL || shards == NULL || shard_count == 0 || frame_size == 0 || frame_size > ISOTP_CAN_FRAME_MAX_SIZE) {
+        return false;
+    }
+
+    memset(engine, 0, sizeof(isotp_engine_t));
+    engine->shards = shards;
+    engine->shard_count = shard_count;
+    engine->frame_size = frame_size;
+
+    //  Idle waits use the same clock as the sessions
+    pthread_condattr_t cond_attr;
+    if(pthread_condattr_init(&cond_attr) != 0) {
+        return false;
+    }
+
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    const bool cond_ok = pthread_cond_init(&engine->idle_cond, &cond_attr) == 0;
+    pthread_condattr_destroy(&cond_attr);
+
+    if(!cond_ok) {
+        return false;
+    }
+
+    if(pthread_mutex_init(&engine->idle_lock, NULL) != 0) {
+        pthread_cond_destroy(&engine->idle_cond);
+        return false;
+    }
+
+    //  Shards
+    for(size_t idx = 0; idx < shard_count; idx++) {
+        isotp_engine_shard_t* shard = &shards[idx];
+        memset(shard, 0, sizeof(isotp_engine_shard_t));
+        shard->engine = engine;
+
+        isotp_router_init(&shard->router, shard->router_entries, ISOTP_ENGINE_SHARD_SESSIONS * 2);
+        isotp_timer_heap_init(&shard->timer_heap, shard->timer_slots, ISOTP_ENGINE_SHARD_SESSIONS);
+        isotp_frame_queue_init(&shard->rx_queue, shard->rx_frames, NULL, ISOTP_ENGINE_QUEUE_DEPTH);
+        isotp_frame_queue_init(&shard->tx_queue, shard->tx_frames, NULL, ISOTP_ENGINE_QUEUE_DEPTH);
+    }
+
+    return true;
+}
+
+size_t isotp_engine_shard_of(const isotp_engine_t* engine, const uint32_t rx_id) {
+    //  Safety
+    if(engine == NULL || engine->shard_count == 0) {
+        return 0;
+    }
+
+    return engine_hash(rx_id, engine->shard_count);
+}
+
+bool isotp_engine_add(isotp_engine_t* engine, isotp_session_t* session, const uint32_t rx_id, const uint32_t tx_id) {
+    //  Safety
+    if(engine == NULL || session == NULL || engine->running) {
+        return false;
+    }
+
+    isotp_engine_shard_t* shard = &engine->shards[isotp_engine_shard_of(engine, rx_id)];
+
+    //  Keep the router at most half full
+    if(shard->router.count >= ISOTP_ENGINE_SHARD_SESSIONS) {
+        return false;
+    }
+
+    if(!isotp_router_add(&shard->router, session, rx_id, tx_id)) {
+        return false;
+    }
+
+    if(!isotp_timer_heap_attach(&shard->timer_heap, session)) {
+        isotp_router_remove(&shard->router, rx_id);
+        return false;
+    }
+
+    return true;
+}
+
+bool isotp_engine_start(isotp_engine_t* engine) {
+    //  Safety
+    if(engine == NULL || engine->running) {
+        return false;
+    }
+
+    __atomic_store_n(&engine->running, true, __ATOMIC_RELEASE);
+
+    for(size_t idx = 0; idx < engine->shard_count; idx++) {
+        if(pthread_create(&engine->shards[idx].thread, NULL, engine_worker, &engine->shards[idx]) != 0) {
+            //  Unwind the workers already started
+            __atomic_store_n(&engine->running, false, __ATOMIC_RELEASE);
+            engine_wake(engine);
+
+            for(size_t started = 0; started < idx; started++) {
+                pthread_join(engine->shards[started].thread, NULL);
+            }
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void isotp_engine_stop(isotp_engine_t* engine) {
+    //  Safety
+    if(engine == NULL || !engine->running) {
+        return;
+    }
+
+    __atomic_store_n(&engine->running, false, __ATOMIC_RELEASE);
+    engine_wake(engine);
+
+    for(size_t idx = 0; idx < engine->shard_count; idx++) {
+        pthread_join(engine->shards[idx].thread, NULL);
+    }
+}
+
+size_t isotp_engine_dispatch(isotp_engine_t* engine, const isotp_can_frame_t* frames, const size_t frame_count) {
+    //  Safety
+    if(engine == NULL || frames == NULL) {
+        return 0;
+    }
+
+    //  Frames stay in bus order: stop at the first full shard queue so the caller can retry the rest
+    size_t accepted = 0;
+    for(; accepted < frame_count; accepted++) {
+        isotp_engine_shard_t* shard = &engine->shards[engine_hash(frames[accepted].identifier, engine->shard_count)];
+        if(isotp_frame_queue_count(&shard->rx_queue) > shard->rx_queue.mask) {
+            break;
+        }
+
+        //  Only frames too long to store fail here, they are dropped and counted by the queue
+        isotp_frame_queue_push(&shard->rx_queue, frames[accepted].identifier, frames[accepted].data, frames[accepted].length, 0);
+    }
+
+    //  Once per batch
+    if(accepted > 0) {
+        engine_wake(engine);
+    }
+
+    return accepted;
+}
+
+size_t isotp_engine_collect_tx(isotp_engine_t* engine, isotp_can_frame_t* frames, const size_t max_frames) {
+    //  Safety
+    if(engine == NULL || frames == NULL) {
+        return 0;
+    }
+
+    //  One frame per shard per round so no shard starves the bus
+    size_t count = 0;
+    size_t idle_shards = 0;
+    while(count < max_frames && idle_shards < engine->shard_count) {
+        isotp_engine_shard_t* shard = &engine->shards[engine->tx_cursor];
+        engine->tx_cursor = (engine->tx_cursor + 1) % engine->shard_count;
+
+        if(isotp_frame_queue_pop(&shard->tx_queue, &frames[count], NULL, 1) == 0) {
+            idle_shards++;
+            continue;
+        }
+
+        idle_shards = 0;
+        count++;
+    }
+
+    return count;
+}
+
+size_t isotp_engine_send(isotp_engine_t* engine, const uint32_t rx_id, const uint8_t* data, const size_t data_length) {
+    //  Safety
+    if(engine == NULL) {
+        return 0;
+    }
+
+    isotp_engine_shard_t* shard = &engine->shards[isotp_engine_shard_of(engine, rx_id)];
+
+    //  Wait for the shard to be free, workers only hold it for one batch
+    while(!engine_claim(shard)) {
+        sched_yield();
+    }
+
+    size_t sent = 0;
+    isotp_router_entry_t* entry = isotp_router_find(&shard->router, rx_id);
+    if(entry != NULL) {
+        sent = isotp_session_send(entry->session, data, data_length);
+    }
+
+    engine_release(shard);
+
+    //  First frame is picked up by the next worker pass
+    if(sent > 0) {
+        engine_wake(engine);
+    }
+
+    return sent;
+}
+
+#endif
@@ -0,0 +1,205 @@
+#pragma once
+
+/*
+    ISO-TP Sharded Session Engine
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Linux only. Spreads sessions across worker threads for gateways that run more sessions than a single core
+    can process. Sessions are assigned to a shard by the identifier they receive on. Each shard owns its own router,
+    timer heap and a pair of frame queues (see isotp_frame_queue.h), and is cache-line aligned so workers never
+    share lines. The bus I/O thread only moves frames: it dispatches recieved frames into the shards' RX queues
+    and collects frames to transmit from their TX queues.
+
+    A shard is only ever processed by the thread holding its busy flag. Workers process their own shard, and when
+    idle they steal RX backlog from other shards by claiming those shards' busy flags. Frames of a session are
+    therefore always processed in order, one thread at a time.
+
+    Session callbacks run on worker threads. Sessions should use `isotp_engine_time_uS` as their `callback_time_uS`
+    so separation time and timeouts are honored. Sessions must only be touched from their callbacks or through
+    `isotp_engine_send` once the engine is started.
+    This header is not part of `isotplib.h`, include it directly and link with -pthread.
+*/
+
+#if defined(__linux__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "isotp_router.h"
+#include "isotp_timer.h"
+#include "isotp_frame_queue.h"
+
+//  Sessions per shard (power of two)
+#ifndef ISOTP_ENGINE_SHARD_SESSIONS
+#define ISOTP_ENGINE_SHARD_SESSIONS 256
+#endif
+
+//  Frames each shard queue holds in either direction (power of two)
+#ifndef ISOTP_ENGINE_QUEUE_DEPTH
+#define ISOTP_ENGINE_QUEUE_DEPTH 256
+#endif
+
+//  Frames processed per shard before moving on, bounds the latency other shards see
+#ifndef ISOTP_ENGINE_BATCH_SIZE
+#define ISOTP_ENGINE_BATCH_SIZE 64
+#endif
+
+//  Longest time an idle worker sleeps before re-checking timers
+#ifndef ISOTP_ENGINE_IDLE_uS
+#define ISOTP_ENGINE_IDLE_uS 1000
+#endif
+
+#ifndef ISOTP_ENGINE_CACHE_LINE
+#define ISOTP_ENGINE_CACHE_LINE 64
+#endif
+
+struct isotp_engine_s;
+
+//  Shard (one per worker thread)
+typedef struct __attribute__((aligned(ISOTP_ENGINE_CACHE_LINE))) isotp_engine_shard_s {
+	//	Sessions
+	isotp_router_t router;												//  Sessions of this shard by recieve identifier
+	isotp_router_entry_t router_entries[ISOTP_ENGINE_SHARD_SESSIONS * 2];	//  Router slots (half full at most)
+	isotp_timer_heap_t timer_heap;										//  Deadlines of this shard's sessions
+	isotp_session_t* timer_slots[ISOTP_ENGINE_SHARD_SESSIONS];			//  Timer heap slots
+
+	//	Handoff with the bus I/O thread
+	isotp_frame_queue_t rx_queue;										//  Recieved frames, pushed by the I/O thread
+	isotp_frame_queue_t tx_queue;										//  Frames to transmit, collected by the I/O thread
+	isotp_can_frame_t rx_frames[ISOTP_ENGINE_QUEUE_DEPTH];				//  RX queue storage
+	isotp_can_frame_t tx_frames[ISOTP_ENGINE_QUEUE_DEPTH];				//  TX queue storage
+
+	//	Worker
+	struct isotp_engine_s* engine;										//  Owning engine
+	pthread_t thread;													//  Worker thread
+	bool busy;															//  (Live) Claimed by the thread currently processing the shard
+	uint64_t frames_processed;											//  (Live) Recieved frames processed
+	uint64_t frames_stolen;												//  (Live) Recieved frames processed by other shards' workers
+} isotp_engine_shard_t;
+
+//  Engine
+typedef struct isotp_engine_s {
+	//	Configuration
+	isotp_engine_shard_t* shards;										//  User provided shards (static or aligned storage)
+	size_t shard_count;													//  Number of shards, one worker thread each
+	size_t frame_size;													//  Size of transmitted frames (8 = classic CAN, up to 64 for CAN FD)
+
+	/**
+	 * @brief (optional) Run on a worker thread after it queued frames to transmit, so the I/O thread can be woken (ex: eventfd)
+	 *
+	 * @param context `tx_ready_context`
+	 */
+	void (*callback_tx_ready)(void* context);
+	void* tx_ready_context;												//  Context passed to `callback_tx_ready`
+
+	//	Workers
+	bool running;														//  (Live) Workers keep running while set
+	size_t sleepers;													//  (Live) Workers waiting for work
+	size_t wake_seq;													//  (Live) Incremented whenever work is handed to the workers
+	pthread_mutex_t idle_lock;											//  Guards idle waits
+	pthread_cond_t idle_cond;											//  Signalled when frames are dispatched
+
+	//	I/O thread
+	size_t tx_cursor;													//  (Live) Shard to resume collecting from
+} isotp_engine_t;
+
+/**
+ * @brief Monotonic clock for `callback_time_uS` (CLOCK_MONOTONIC, the clock workers sleep on)
+ *
+ * @param context Unused
+ * @return uint64_t Current time in microseconds
+ */
+uint64_t isotp_engine_time_uS(void* context);
+
+/**
+ * @brief Initializes an engine over user provided shards. Workers are not started yet.
+ *
+ * @param engine Engine to initialize
+ * @param shards Shard storage (one worker thread per shard)
+ * @param shard_count Number of shards
+ * @param frame_size Size of transmitted frames
+ * @return true Engine initialized
+ * @return false Invalid parameters or pthread primitives could not be created
+ */
+bool isotp_engine_init(isotp_engine_t* engine, isotp_engine_shard_t* shards, const size_t shard_count, const size_t frame_size);
+
+/**
+ * @brief Shard a recieve identifier maps to
+ *
+ * @param engine Engine to query
+ * @param rx_id Identifier
+ * @return size_t Shard index
+ */
+size_t isotp_engine_shard_of(const isotp_engine_t* engine, const uint32_t rx_id);
+
+/**
+ * @brief Registers a session with the shard its recieve identifier maps to (before `isotp_engine_start`)
+ *
+ * @param engine Engine to register with
+ * @param session Initialized session, attached to the shard's timer heap
+ * @param rx_id Identifier the session receives on
+ * @param tx_id Identifier the session transmits on
+ * @return true Session registered
+ * @return false Shard full, identifier already registered or engine running
+ */
+bool isotp_engine_add(isotp_engine_t* engine, isotp_session_t* session, const uint32_t rx_id, const uint32_t tx_id);
+
+/**
+ * @brief Starts one worker thread per shard
+ *
+ * @param engine Engine to start
+ * @return true Workers running
+ * @return false Already running or a thread could not be created (no workers are left running)
+ */
+bool isotp_engine_start(isotp_engine_t* engine);
+
+/**
+ * @brief Stops and joins all worker threads
+ *
+ * @param engine Engine to stop
+ */
+void isotp_engine_stop(isotp_engine_t* engine);
+
+/**
+ * @brief Hands recieved frames to their shards in order and wakes idle workers (bus I/O thread only). Stops at the
+ * first frame whose shard queue is full, so no frame of a transfer is lost: retry the rest once workers caught up.
+ *
+ * @param engine Engine to feed
+ * @param frames Recieved frames
+ * @param frame_count Number of frames
+ * @return size_t Number of leading frames accepted (`frame_count` = all)
+ */
+size_t isotp_engine_dispatch(isotp_engine_t* engine, const isotp_can_frame_t* frames, const size_t frame_count);
+
+/**
+ * @brief Collects frames the workers queued for transmission, round-robin across shards (bus I/O thread only)
+ *
+ * @param engine Engine to collect from
+ * @param frames Outputted frames, `identifier` is the identifier to send on
+ * @param max_frames Capacity of `frames`
+ * @return size_t Number of frames collected
+ */
+size_t isotp_engine_collect_tx(isotp_engine_t* engine, isotp_can_frame_t* frames, const size_t max_frames);
+
+/**
+ * @brief Starts a transmission on a registered session from a thread outside the engine (see `isotp_session_send`).
+ * Inside session callbacks, call `isotp_session_send` on the callback's session directly instead.
+ *
+ * @param engine Engine the session is registered with
+ * @param rx_id Recieve identifier of the session
+ * @param data Data to send
+ * @param data_length Length of data
+ * @return size_t Bytes queued for transmission (0 = unknown session or nothing sent)
+ */
+size_t isotp_engine_send(isotp_engine_t* engine, const uint32_t rx_id, const uint8_t* data, const size_t data_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+#include <string.h>
+#include "isotp_frame_queue.h"
+
+bool isotp_frame_queue_init(isotp_frame_queue_t* queue, isotp_can_frame_t* frames, uint64_t* timestamps, const size_t capacity) {
+    //  Safety (capacity must be a power of two so indices can be masked)
+    if(queue == NULL || frames == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    queue->frames = frames;
+    queue->timestamps = timestamps;
+    queue->mask = capacity - 1;
+    queue->head = 0;
+    queue->dropped = 0;
+    queue->tail = 0;
+    queue->last_timestamp_uS = 0;
+
+    return true;
+}
+
+bool isotp_frame_queue_push(isotp_frame_queue_t* queue, const uint32_t identifier, const uint8_t* data, const size_t length, const uint64_t timestamp_uS) {
+    //  Safety
+    if(queue == NULL || (data == NULL && length > 0)) {
+        return false;
+    }
+
+    //  Only the producer writes head, the consumer publishes tail
+    const size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    const size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    //  Full or unstorable, drop rather than wait
+    if(head - tail > queue->mask || length > ISOTP_CAN_FRAME_MAX_SIZE) {
+        __atomic_store_n(&queue->dropped, queue->dropped + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    //  Fill slot
+    const size_t idx = head & queue->mask;
+    isotp_can_frame_t* frame = &queue->frames[idx];
+    frame->identifier = identifier;
+    frame->length = (uint8_t)length;
+    if(length > 0) { memcpy(frame->data, data, length); }
+
+    if(queue->timestamps != NULL) {
+        queue->timestamps[idx] = timestamp_uS;
+    }
+
+    //  Publish
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t isotp_frame_queue_count(const isotp_frame_queue_t* queue) {
+    //  Safety
+    if(queue == NULL) {
+        return 0;
+    }
+
+    return __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+}
+
+uint32_t isotp_frame_queue_dropped(const isotp_frame_queue_t* queue) {
+    //  Safety
+    if(queue == NULL) {
+        return 0;
+    }
+
+    return __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+}
+
+size_t isotp_frame_queue_pop(isotp_frame_queue_t* queue, isotp_can_frame_t* frames, uint64_t* timestamps, const size_t max_frames) {
+    //  Safety
+    if(queue == NULL || frames == NULL) {
+        return 0;
+    }
+
+    const size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    const size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+    size_t count = head - tail;
+    if(count > max_frames) {
+        count = max_frames;
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        const size_t idx = (tail + i) & queue->mask;
+        const isotp_can_frame_t* frame = &queue->frames[idx];
+
+        //  Only the used part of the frame
+        frames[i].identifier = frame->identifier;
+        frames[i].length = frame->length;
+        memcpy(frames[i].data, frame->data, frame->length);
+
+        if(timestamps != NULL) {
+            timestamps[i] = (queue->timestamps != NULL) ? queue->timestamps[idx] : 0;
+        }
+    }
+
+    if(count > 0 && queue->timestamps != NULL) {
+        queue->last_timestamp_uS = queue->timestamps[(tail + count - 1) & queue->mask];
+    }
+
+    //  Hand the slots back to the producer
+    __atomic_store_n(&queue->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+size_t isotp_frame_queue_pump(isotp_frame_queue_t* queue, void (*callback_batch)(void* context, const isotp_can_frame_t* frames, const size_t frame_count), void* context, const size_t max_frames) {
+    //  Safety
+    if(queue == NULL || callback_batch == NULL) {
+        return 0;
+    }
+
+    const size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+    size_t remaining = head - tail;
+    if(max_frames > 0 && remaining > max_frames) {
+        remaining = max_frames;
+    }
+
+    size_t processed = 0;
+    while(remaining > 0) {
+        //  Run up to the end of the storage (wraps at most once)
+        const size_t idx = tail & queue->mask;
+        size_t run = queue->mask + 1 - idx;
+        if(run > remaining) {
+            run = remaining;
+        }
+
+        if(queue->timestamps != NULL) {
+            queue->last_timestamp_uS = queue->timestamps[idx + run - 1];
+        }
+
+        callback_batch(context, &queue->frames[idx], run);
+
+        //  Hand the slots back to the producer
+        tail += run;
+        __atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+
+        processed += run;
+        remaining -= run;
+    }
+
+    return processed;
+}
+
+//  Batch consumer of `isotp_frame_queue_pump_session`
+static void frame_queue_session_batch(void* context, const isotp_can_frame_t* frames, const size_t frame_count) {
+    isotp_session_can_rx_batch((isotp_session_t*)context, frames, frame_count);
+}
+
+size_t isotp_frame_queue_pump_session(isotp_frame_queue_t* queue, isotp_session_t* session, const size_t max_frames) {
+    //  Safety
+    if(queue == NULL || session == NULL) {
+        return 0;
+    }
+
+    return isotp_frame_queue_pump(queue, frame_queue_session_batch, session, max_frames);
+}
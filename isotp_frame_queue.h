@@ -0,0 +1,125 @@
+#pragma once
+
+/*
+    ISO-TP Frame Queue
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Wait-free single producer / single consumer queue of recieved CAN frames, placed in front of a session or router
+    so the CAN RX interrupt only copies (identifier, length, data, timestamp) into a slot. A task-context pump later
+    drains the queue into the session state machine through the batch APIs, so user callbacks never run inside
+    the interrupt. Frames are stored as `isotp_can_frame_t`, so the pump hands runs of the queue storage directly to
+    `isotp_session_can_rx_batch`/`isotp_router_can_rx_batch` without copying them again. The router pump is part of
+    isotp_router.c, so only users of the router need to link it.
+
+    Exactly one context may push (ex: the CAN RX interrupt) and exactly one context may pump.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+
+//  Spacing between the producer and consumer indices, so pumping from another core does not slow down pushing
+#ifndef ISOTP_FRAME_QUEUE_CACHE_LINE
+#define ISOTP_FRAME_QUEUE_CACHE_LINE 64
+#endif
+
+//  Frame queue
+typedef struct {
+	//	Configuration
+	isotp_can_frame_t* frames;				//  User provided frame storage
+	uint64_t* timestamps;					//  (Optional) User provided timestamp storage, same capacity as `frames` (NULL = not kept)
+	size_t mask;							//  Capacity - 1 (capacity is a power of two)
+
+	//	Producer
+	uint8_t pad_producer[ISOTP_FRAME_QUEUE_CACHE_LINE];
+	size_t head;							//  (Live) Frames pushed
+	uint32_t dropped;						//  (Live) Frames dropped because the queue was full or the frame too long
+
+	//	Consumer
+	uint8_t pad_consumer[ISOTP_FRAME_QUEUE_CACHE_LINE];
+	size_t tail;							//  (Live) Frames pumped
+	uint64_t last_timestamp_uS;				//  (Live) Timestamp of the last frame pumped (requires `timestamps`)
+} isotp_frame_queue_t;
+
+/**
+ * @brief Initializes a frame queue over user provided storage
+ *
+ * @param queue Queue to initialize
+ * @param frames Frame storage
+ * @param timestamps (Optional) Timestamp storage with `capacity` entries
+ * @param capacity Number of frames, must be a power of two
+ * @return true Queue initialized
+ * @return false Invalid parameters
+ */
+bool isotp_frame_queue_init(isotp_frame_queue_t* queue, isotp_can_frame_t* frames, uint64_t* timestamps, const size_t capacity);
+
+/**
+ * @brief Enqueues a recieved frame. Wait-free and safe to call from an interrupt, does not run any session code.
+ *
+ * @param queue Queue to push to
+ * @param identifier Arbitration ID
+ * @param data Frame data
+ * @param length Frame data length (at most `ISOTP_CAN_FRAME_MAX_SIZE`)
+ * @param timestamp_uS Reception time (kept only if the queue has timestamp storage)
+ * @return true Frame queued
+ * @return false Queue full or frame too long, the frame was dropped and counted
+ */
+bool isotp_frame_queue_push(isotp_frame_queue_t* queue, const uint32_t identifier, const uint8_t* data, const size_t length, const uint64_t timestamp_uS);
+
+/**
+ * @brief Number of frames waiting to be pumped
+ *
+ * @param queue Queue to query
+ * @return size_t Queued frames
+ */
+size_t isotp_frame_queue_count(const isotp_frame_queue_t* queue);
+
+/**
+ * @brief Number of frames dropped since init
+ *
+ * @param queue Queue to query
+ * @return uint32_t Dropped frames
+ */
+uint32_t isotp_frame_queue_dropped(const isotp_frame_queue_t* queue);
+
+/**
+ * @brief Copies queued frames out for processing elsewhere (consumer side, alternative to the pumps)
+ *
+ * @param queue Queue to drain
+ * @param frames Outputted frames, oldest first
+ * @param timestamps (Optional) Outputted timestamps (requires queue timestamp storage)
+ * @param max_frames Capacity of `frames`
+ * @return size_t Number of frames copied
+ */
+size_t isotp_frame_queue_pop(isotp_frame_queue_t* queue, isotp_can_frame_t* frames, uint64_t* timestamps, const size_t max_frames);
+
+/**
+ * @brief Drains queued frames into a session with `isotp_session_can_rx_batch` (identifiers are ignored, filter before pushing)
+ *
+ * @param queue Queue to drain
+ * @param session Session to feed
+ * @param max_frames Maximum frames to process in this call (0 = all queued)
+ * @return size_t Number of frames processed
+ */
+size_t isotp_frame_queue_pump_session(isotp_frame_queue_t* queue, isotp_session_t* session, const size_t max_frames);
+
+/**
+ * @brief Drains queued frames into any batch consumer, handing it contiguous runs of the queue storage. Each run is
+ * released to the producer as soon as `callback_batch` returns.
+ *
+ * @param queue Queue to drain
+ * @param callback_batch Processes a run of frames, oldest first
+ * @param context Context passed to `callback_batch`
+ * @param max_frames Maximum frames to process in this call (0 = all queued)
+ * @return size_t Number of frames processed
+ */
+size_t isotp_frame_queue_pump(isotp_frame_queue_t* queue, void (*callback_batch)(void* context, const isotp_can_frame_t* frames, const size_t frame_count), void* context, const size_t max_frames);
+
+#ifdef __cplusplus
+}
+#endif
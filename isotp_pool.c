@@ -0,0 +1,234 @@
+#include "isotp_pool.h"
+
+//  Free stack word: ABA tag in the upper half, top block index + 1 in the lower half
+#define POOL_TOP_INDEX_MASK 0xFFFFu
+#define POOL_TOP_TAG_SHIFT 16
+
+//  Next-free link, kept in the first word of each free block
+static inline uint32_t* pool_link(const isotp_pool_class_t* cls, const uint32_t idx) {
+    return (uint32_t*)((uint8_t*)cls->storage + (size_t)idx * cls->block_size);
+}
+
+//  New stack word with the tag advanced, so a stale compare-exchange fails even if the same block is back on top
+static inline uint32_t pool_top(const uint32_t previous, const uint32_t link) {
+    return ((((previous >> POOL_TOP_TAG_SHIFT) + 1) << POOL_TOP_TAG_SHIFT) | link);
+}
+
+static void* pool_pop(isotp_pool_class_t* cls) {
+    uint32_t top = __atomic_load_n(&cls->free_top, __ATOMIC_ACQUIRE);
+
+    while(true) {
+        const uint32_t link = top & POOL_TOP_INDEX_MASK;
+        if(link == 0) {
+            return NULL;
+        }
+
+        //  May read a block another thread just took, the tag then fails the exchange
+        const uint32_t next = __atomic_load_n(pool_link(cls, link - 1), __ATOMIC_RELAXED);
+        if(__atomic_compare_exchange_n(&cls->free_top, &top, pool_top(top, next), true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            return pool_link(cls, link - 1);
+        }
+    }
+}
+
+static void pool_push(isotp_pool_class_t* cls, const uint32_t idx) {
+    uint32_t* block_link = pool_link(cls, idx);
+    uint32_t top = __atomic_load_n(&cls->free_top, __ATOMIC_RELAXED);
+
+    do {
+        __atomic_store_n(block_link, top & POOL_TOP_INDEX_MASK, __ATOMIC_RELAXED);
+    } while(!__atomic_compare_exchange_n(&cls->free_top, &top, pool_top(top, idx + 1), true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+bool isotp_pool_init(isotp_pool_t* pool, isotp_pool_class_t* classes, const size_t class_count) {
+    //  Safety
+    if(pool == NULL || classes == NULL || class_count == 0) {
+        return false;
+    }
+
+    //  Classes must be usable and ascending, so the first class that fits is the smallest
+    for(size_t i = 0; i < class_count; i++) {
+        const isotp_pool_class_t* cls = &classes[i];
+        if(cls->storage == NULL || ((uintptr_t)cls->storage % sizeof(uint32_t)) != 0 ||
+           cls->block_size < sizeof(uint32_t) || (cls->block_size % sizeof(uint32_t)) != 0 ||
+           cls->block_count == 0 || cls->block_count > ISOTP_POOL_CLASS_BLOCKS_MAX) {
+            return false;
+        }
+
+        if(i > 0 && cls->block_size <= classes[i - 1].block_size) {
+            return false;
+        }
+    }
+
+    //  Chain every block onto its free stack, lowest address on top
+    for(size_t i = 0; i < class_count; i++) {
+        isotp_pool_class_t* cls = &classes[i];
+        for(uint32_t idx = 0; idx < cls->block_count; idx++) {
+            *pool_link(cls, idx) = (idx + 1 < cls->block_count) ? idx + 2 : 0;
+        }
+
+        cls->free_top = 1;
+        cls->in_use = 0;
+        cls->high_water = 0;
+        cls->allocations = 0;
+        cls->exhausted = 0;
+    }
+
+    pool->classes = classes;
+    pool->class_count = class_count;
+
+    return true;
+}
+
+void* isotp_pool_alloc(isotp_pool_t* pool, const size_t length, size_t* block_size) {
+    //  Safety
+    if(pool == NULL || pool->classes == NULL) {
+        return NULL;
+    }
+
+    for(size_t i = 0; i < pool->class_count; i++) {
+        isotp_pool_class_t* cls = &pool->classes[i];
+        if(cls->block_size < length) {
+            continue;
+        }
+
+        void* block = pool_pop(cls);
+        if(block == NULL) {
+            //  Class empty, fall back to a larger one
+            __atomic_add_fetch(&cls->exhausted, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        //  Counters
+        __atomic_add_fetch(&cls->allocations, 1, __ATOMIC_RELAXED);
+        const uint32_t in_use = __atomic_add_fetch(&cls->in_use, 1, __ATOMIC_RELAXED);
+        uint32_t high_water = __atomic_load_n(&cls->high_water, __ATOMIC_RELAXED);
+        while(in_use > high_water && !__atomic_compare_exchange_n(&cls->high_water, &high_water, in_use, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+
+        if(block_size != NULL) { *block_size = cls->block_size; }
+        return block;
+    }
+
+    return NULL;
+}
+
+bool isotp_pool_free(isotp_pool_t* pool, void* block) {
+    //  Safety
+    if(pool == NULL || pool->classes == NULL || block == NULL) {
+        return false;
+    }
+
+    //  Class owning the address
+    for(size_t i = 0; i < pool->class_count; i++) {
+        isotp_pool_class_t* cls = &pool->classes[i];
+        const uintptr_t start = (uintptr_t)cls->storage;
+        const uintptr_t offset = (uintptr_t)block - start;
+        if((uintptr_t)block < start || offset >= cls->block_size * (size_t)cls->block_count) {
+            continue;
+        }
+
+        //  Must be the start of a block
+        if(offset % cls->block_size != 0) {
+            return false;
+        }
+
+        pool_push(cls, (uint32_t)(offset / cls->block_size));
+        __atomic_sub_fetch(&cls->in_use, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    return false;
+}
+
+bool isotp_pool_attach(isotp_pool_t* pool, isotp_session_t* session) {
+    //  Safety
+    if(pool == NULL || session == NULL || session->rx_pool != NULL || session->rx_slots != NULL) {
+        return false;
+    }
+
+    session->rx_pool = pool;
+    session->rx_pool_block = NULL;
+    session->rx_pool_assign = isotp_pool_mem_assign;
+    session->rx_pool_release = isotp_pool_free;
+#ifndef ISOTP_SESSION_SHARED_OPS
+    session->callback_mem_assign = isotp_pool_mem_assign;
+#endif
+
+    return true;
+}
+
+void isotp_pool_detach(isotp_pool_t* pool, isotp_session_t* session) {
+    //  Safety
+    if(pool == NULL || session == NULL || session->rx_pool != pool) {
+        return;
+    }
+
+    //  Abandoned reception
+    if(session->rx_pool_block != NULL) {
+        isotp_pool_free(pool, session->rx_pool_block);
+        session->rx_pool_block = NULL;
+    }
+
+#ifndef ISOTP_SESSION_SHARED_OPS
+    if(session->callback_mem_assign == isotp_pool_mem_assign) {
+        session->callback_mem_assign = NULL;
+    }
+#endif
+
+    session->rx_pool = NULL;
+    session->rx_pool_assign = NULL;
+    session->rx_pool_release = NULL;
+    session->rx_buffer = NULL;
+    session->rx_len = 0;
+}
+
+void isotp_pool_mem_assign(void* context, const size_t indicated_length) {
+    isotp_session_t* session = (isotp_session_t*)context;
+
+    //  Safety
+    if(session == NULL || session->rx_pool == NULL) {
+        return;
+    }
+
+    //  Abandoned reception (delivered messages are owned by the application)
+    if(session->rx_pool_block != NULL) {
+        isotp_pool_free(session->rx_pool, session->rx_pool_block);
+        session->rx_pool_block = NULL;
+    }
+
+    //  Smallest block that fits, or no buffer at all so the message is rejected as too large
+    size_t block_size = 0;
+    void* block = isotp_pool_alloc(session->rx_pool, indicated_length, &block_size);
+    session->rx_pool_block = block;
+    session->rx_buffer = block;
+    session->rx_len = (block != NULL) ? block_size : 0;
+}
+
+size_t isotp_pool_snapshot(isotp_pool_t* pool, isotp_pool_class_stats_t* stats, const size_t max_classes, const bool reset) {
+    //  Safety
+    if(pool == NULL || pool->classes == NULL || stats == NULL) {
+        return 0;
+    }
+
+    size_t count = (pool->class_count < max_classes) ? pool->class_count : max_classes;
+    for(size_t i = 0; i < count; i++) {
+        isotp_pool_class_t* cls = &pool->classes[i];
+        stats[i].block_size = cls->block_size;
+        stats[i].block_count = cls->block_count;
+        stats[i].in_use = __atomic_load_n(&cls->in_use, __ATOMIC_RELAXED);
+
+        if(reset) {
+            stats[i].high_water = __atomic_exchange_n(&cls->high_water, stats[i].in_use, __ATOMIC_RELAXED);
+            stats[i].allocations = __atomic_exchange_n(&cls->allocations, 0, __ATOMIC_RELAXED);
+            stats[i].exhausted = __atomic_exchange_n(&cls->exhausted, 0, __ATOMIC_RELAXED);
+        }
+        else {
+            stats[i].high_water = __atomic_load_n(&cls->high_water, __ATOMIC_RELAXED);
+            stats[i].allocations = __atomic_load_n(&cls->allocations, __ATOMIC_RELAXED);
+            stats[i].exhausted = __atomic_load_n(&cls->exhausted, __ATOMIC_RELAXED);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+/*
+    ISO-TP Receive Buffer Pool
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Deterministic fixed-block allocator for RX buffers, so long running gateways do not fragment the heap by
+    allocating in `callback_mem_assign`. Blocks are grouped in size classes over user provided storage, and each
+    class keeps its free blocks on a lock-free stack: allocating and freeing never block and may happen on any
+    thread, so one pool can serve any number of sessions.
+
+    Attached sessions draw a block of the smallest class that fits on every first (or single) frame, and the
+    application hands it back with `isotp_session_release_rx` once the message is consumed.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+
+//  Most blocks a class may hold (block indices share a 32-bit word with an ABA tag)
+#define ISOTP_POOL_CLASS_BLOCKS_MAX 0xFFFE
+
+//  Size class
+typedef struct {
+	void* storage;							//  User provided memory, `block_size * block_count` bytes aligned for uint32_t
+	size_t block_size;						//  Bytes per block, a multiple of 4
+	uint32_t block_count;					//  Number of blocks (at most ISOTP_POOL_CLASS_BLOCKS_MAX)
+
+	uint32_t free_top;						//  (Live) Free stack: ABA tag << 16 | (top block index + 1), 0 = empty
+	uint32_t in_use;						//  (Live) Blocks allocated
+	uint32_t high_water;					//  (Live) Most blocks allocated at once
+	uint32_t allocations;					//  (Live) Blocks handed out
+	uint32_t exhausted;						//  (Live) Allocations that found the class empty and moved on to a larger class
+} isotp_pool_class_t;
+
+//  Pool
+typedef struct isotp_pool_s {
+	isotp_pool_class_t* classes;			//  User provided size classes, ascending by `block_size`
+	size_t class_count;						//  Number of classes
+} isotp_pool_t;
+
+//  Snapshot of a size class, see `isotp_pool_snapshot`
+typedef struct {
+	size_t block_size;						//  Bytes per block
+	uint32_t block_count;					//  Number of blocks
+	uint32_t in_use;						//  Blocks allocated
+	uint32_t high_water;					//  Most blocks allocated at once
+	uint32_t allocations;					//  Blocks handed out
+	uint32_t exhausted;						//  Allocations that found the class empty
+} isotp_pool_class_stats_t;
+
+/**
+ * @brief Initializes a pool over user provided size classes (`storage`, `block_size` and `block_count` filled in), all blocks free
+ *
+ * @param pool Pool to initialize
+ * @param classes Size classes, strictly ascending by `block_size`
+ * @param class_count Number of classes
+ * @return true Pool initialized
+ * @return false Invalid parameters
+ */
+bool isotp_pool_init(isotp_pool_t* pool, isotp_pool_class_t* classes, const size_t class_count);
+
+/**
+ * @brief Takes a block of the smallest class that fits and has a free block. Lock-free, safe from any thread.
+ *
+ * @param pool Pool to allocate from
+ * @param length Bytes needed
+ * @param block_size (Optional) Outputted size of the block
+ * @return void* Block (NULL = no class large enough has a free block)
+ */
+void* isotp_pool_alloc(isotp_pool_t* pool, const size_t length, size_t* block_size);
+
+/**
+ * @brief Returns a block to its class. Lock-free, safe from any thread. Each block must be freed once.
+ *
+ * @param pool Pool the block was allocated from
+ * @param block Block to free
+ * @return true Block freed
+ * @return false Not a block of this pool
+ */
+bool isotp_pool_free(isotp_pool_t* pool, void* block);
+
+/**
+ * @brief Draws the session's RX buffers from the pool by installing `isotp_pool_mem_assign` as its `callback_mem_assign`.
+ * Sessions using an `ops` table without `callback_mem_assign` draw from the pool all the same. Every recieved message is then owned by the application from `callback_transmission_rx` on, and its block must be
+ * handed back with `isotp_session_release_rx`. Only while the session is idle.
+ *
+ * @param pool Pool to draw from
+ * @param session Session without receive slots
+ * @return true Session attached
+ * @return false Session already attached to a pool or using receive slots
+ */
+bool isotp_pool_attach(isotp_pool_t* pool, isotp_session_t* session);
+
+/**
+ * @brief Stops drawing RX buffers from the pool. The block of an abandoned reception is freed and the session is left
+ * without an RX buffer, select one with `isotp_session_use_rx_buffer`. Blocks held by the application stay valid.
+ *
+ * @param pool Pool the session is attached to
+ * @param session Session to detach
+ */
+void isotp_pool_detach(isotp_pool_t* pool, isotp_session_t* session);
+
+/**
+ * @brief `callback_mem_assign` of attached sessions, may be called from a user callback instead. Frees the block of an
+ * abandoned reception and selects a block for `indicated_length`. When none is free the session is left without an RX
+ * buffer, so the message is rejected through `callback_error_transmission_too_large`.
+ *
+ * @param context Session attached to a pool (the session itself, not its `user_context`)
+ * @param indicated_length Length of the message starting
+ */
+void isotp_pool_mem_assign(void* context, const size_t indicated_length);
+
+/**
+ * @brief Copies the counters of each size class
+ *
+ * @param pool Pool to read
+ * @param stats Outputted counters, one per class
+ * @param max_classes Capacity of `stats`
+ * @param reset Restart `allocations` and `exhausted` from zero and `high_water` from the blocks currently in use
+ * @return size_t Number of classes copied
+ */
+size_t isotp_pool_snapshot(isotp_pool_t* pool, isotp_pool_class_stats_t* stats, const size_t max_classes, const bool reset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,384 @@
+#include <string.h>
+#include "isotp_router.h"
+
+//  Mix identifier bits so sequential IDs (0x7E0, 0x7E1, ...) spread across the table
+static inline size_t router_hash(const uint32_t id, const size_t mask) {
+    uint32_t h = id;
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return (size_t)h & mask;
+}
+
+//  Whether a slot holds a session or a shared identifier
+static inline bool router_slot_used(const isotp_router_entry_t* entry) {
+    return entry->session != NULL || entry->addressed != NULL;
+}
+
+//  Find slot index of `rx_id`, or capacity if not registered
+static size_t router_find_index(const isotp_router_t* router, const uint32_t rx_id) {
+    const size_t mask = router->capacity - 1;
+    size_t idx = router_hash(rx_id, mask);
+
+    for(size_t probes = 0; probes < router->capacity; probes++) {
+        const isotp_router_entry_t* entry = &router->entries[idx];
+
+        //  Empty slot terminates the probe sequence
+        if(!router_slot_used(entry)) {
+            break;
+        }
+
+        if(entry->rx_id == rx_id) {
+            return idx;
+        }
+
+        idx = (idx + 1) & mask;
+    }
+
+    return router->capacity;
+}
+
+bool isotp_router_init(isotp_router_t* router, isotp_router_entry_t* entries, size_t capacity) {
+    //  Safety
+    if(router == NULL || entries == NULL || capacity == 0) {
+        return false;
+    }
+
+    //  Capacity must be a power of two for mask based probing
+    if((capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    //  Clear table
+    memset(entries, 0, capacity * sizeof(isotp_router_entry_t));
+
+    router->entries = entries;
+    router->capacity = capacity;
+    router->count = 0;
+    router->tx_cursor = 0;
+
+    return true;
+}
+
+//  Claims a slot for `rx_id` holding either a session or a shared identifier table
+static bool router_insert(isotp_router_t* router, isotp_session_t* session, isotp_session_t** addressed, const uint32_t rx_id, const uint32_t tx_id) {
+    //  Table full
+    if(router->count >= router->capacity) {
+        return false;
+    }
+
+    //  Linear probe for a free slot, rejecting duplicates
+    const size_t mask = router->capacity - 1;
+    size_t idx = router_hash(rx_id, mask);
+
+    while(router_slot_used(&router->entries[idx])) {
+        if(router->entries[idx].rx_id == rx_id) {
+            return false;
+        }
+
+        idx = (idx + 1) & mask;
+    }
+
+    //  Register
+    router->entries[idx].session = session;
+    router->entries[idx].addressed = addressed;
+    router->entries[idx].rx_id = rx_id;
+    router->entries[idx].tx_id = tx_id;
+    router->entries[idx].address_cursor = 0;
+    router->count++;
+
+    return true;
+}
+
+bool isotp_router_add(isotp_router_t* router, isotp_session_t* session, const uint32_t rx_id, const uint32_t tx_id) {
+    //  Safety
+    if(router == NULL || router->entries == NULL || session == NULL) {
+        return false;
+    }
+
+    return router_insert(router, session, NULL, rx_id, tx_id);
+}
+
+bool isotp_router_add_shared(isotp_router_t* router, isotp_session_t** sessions, const uint32_t rx_id, const uint32_t tx_id) {
+    //  Safety
+    if(router == NULL || router->entries == NULL || sessions == NULL) {
+        return false;
+    }
+
+    if(!router_insert(router, NULL, sessions, rx_id, tx_id)) {
+        return false;
+    }
+
+    //  No addresses attached yet
+    memset(sessions, 0, ISOTP_ROUTER_ADDRESS_COUNT * sizeof(isotp_session_t*));
+    return true;
+}
+
+bool isotp_router_attach(isotp_router_t* router, isotp_session_t* session, const uint32_t rx_id) {
+    //  Safety
+    if(session == NULL || session->protocol_config.addressing_mode == ISOTP_ADDRESSING_NORMAL) {
+        return false;
+    }
+
+    //  Shared identifiers only
+    isotp_router_entry_t* entry = isotp_router_find(router, rx_id);
+    if(entry == NULL || entry->addressed == NULL) {
+        return false;
+    }
+
+    //  Address taken
+    const uint8_t address = session->protocol_config.rx_address;
+    if(entry->addressed[address] != NULL) {
+        return false;
+    }
+
+    entry->addressed[address] = session;
+    return true;
+}
+
+bool isotp_router_detach(isotp_router_t* router, const uint32_t rx_id, const uint8_t address) {
+    //  Shared identifiers only
+    isotp_router_entry_t* entry = isotp_router_find(router, rx_id);
+    if(entry == NULL || entry->addressed == NULL || entry->addressed[address] == NULL) {
+        return false;
+    }
+
+    entry->addressed[address] = NULL;
+    return true;
+}
+
+bool isotp_router_remove(isotp_router_t* router, const uint32_t rx_id) {
+    //  Safety
+    if(router == NULL || router->entries == NULL) {
+        return false;
+    }
+
+    size_t hole = router_find_index(router, rx_id);
+    if(hole >= router->capacity) {
+        return false;
+    }
+
+    //  Backward shift deletion keeps probe sequences intact without tombstones
+    const size_t mask = router->capacity - 1;
+    size_t idx = (hole + 1) & mask;
+
+    while(router_slot_used(&router->entries[idx])) {
+        size_t home = router_hash(router->entries[idx].rx_id, mask);
+
+        //  Move entry into the hole if its home slot is not between the hole and its current slot
+        if(((idx - home) & mask) >= ((idx - hole) & mask)) {
+            router->entries[hole] = router->entries[idx];
+            hole = idx;
+        }
+
+        idx = (idx + 1) & mask;
+    }
+
+    //  Clear final hole
+    memset(&router->entries[hole], 0, sizeof(isotp_router_entry_t));
+    router->count--;
+
+    return true;
+}
+
+isotp_router_entry_t* isotp_router_find(const isotp_router_t* router, const uint32_t rx_id) {
+    //  Safety
+    if(router == NULL || router->entries == NULL) {
+        return NULL;
+    }
+
+    size_t idx = router_find_index(router, rx_id);
+    if(idx >= router->capacity) {
+        return NULL;
+    }
+
+    return &router->entries[idx];
+}
+
+//  Session a frame on `entry` belongs to, selected by the address byte on shared identifiers
+static inline isotp_session_t* router_session_of(const isotp_router_entry_t* entry, const uint8_t* frame_data, const size_t frame_length) {
+    if(entry->addressed == NULL) {
+        return entry->session;
+    }
+
+    if(frame_data == NULL || frame_length <= ISOTP_SPEC_FRAME_ADDRESS_IDX) {
+        return NULL;
+    }
+
+    return entry->addressed[frame_data[ISOTP_SPEC_FRAME_ADDRESS_IDX]];
+}
+
+bool isotp_router_can_rx(isotp_router_t* router, const uint32_t identifier, const uint8_t* frame_data, const size_t frame_length) {
+    //  Lookup session
+    isotp_router_entry_t* entry = isotp_router_find(router, identifier);
+    if(entry == NULL) {
+        return false;
+    }
+
+    isotp_session_t* session = router_session_of(entry, frame_data, frame_length);
+    if(session == NULL) {
+        return false;
+    }
+
+    //  Dispatch
+    isotp_session_can_rx(session, frame_data, frame_length);
+    return true;
+}
+
+size_t isotp_router_can_rx_batch(isotp_router_t* router, const isotp_can_frame_t* frames, const size_t frame_count) {
+    //  Safety
+    if(router == NULL || frames == NULL) {
+        return 0;
+    }
+
+    size_t routed = 0;
+    size_t idx = 0;
+
+    while(idx < frame_count) {
+        //  Group back-to-back frames for the same identifier
+        const uint32_t identifier = frames[idx].identifier;
+        size_t run = 1;
+        while(idx + run < frame_count && frames[idx + run].identifier == identifier) {
+            run++;
+        }
+
+        //  Dispatch run
+        isotp_router_entry_t* entry = isotp_router_find(router, identifier);
+        if(entry != NULL && entry->addressed == NULL) {
+            isotp_session_can_rx_batch(entry->session, frames + idx, run);
+            routed += run;
+        }
+        else if(entry != NULL) {
+            //  Shared identifier: split into back-to-back frames for the same address
+            size_t sub = 0;
+            while(sub < run) {
+                const isotp_can_frame_t* first = &frames[idx + sub];
+                size_t sub_run = 1;
+                while(sub + sub_run < run && first->length > ISOTP_SPEC_FRAME_ADDRESS_IDX && frames[idx + sub + sub_run].length > ISOTP_SPEC_FRAME_ADDRESS_IDX &&
+                      frames[idx + sub + sub_run].data[ISOTP_SPEC_FRAME_ADDRESS_IDX] == first->data[ISOTP_SPEC_FRAME_ADDRESS_IDX]) {
+                    sub_run++;
+                }
+
+                isotp_session_t* session = router_session_of(entry, first->data, first->length);
+                if(session != NULL) {
+                    isotp_session_can_rx_batch(session, first, sub_run);
+                    routed += sub_run;
+                }
+
+                sub += sub_run;
+            }
+        }
+
+        idx += run;
+    }
+
+    return routed;
+}
+
+//  Polls the sessions attached to a shared identifier round-robin, resuming after the last address that transmitted
+static size_t router_shared_can_tx(isotp_router_entry_t* entry, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS) {
+    for(size_t i = 0; i < ISOTP_ROUTER_ADDRESS_COUNT; i++) {
+        const uint8_t address = (uint8_t)(entry->address_cursor + i);
+        isotp_session_t* session = entry->addressed[address];
+        if(session == NULL) {
+            continue;
+        }
+
+        size_t len = isotp_session_can_tx(session, frame_data, frame_size, requested_separation_uS);
+        if(len > 0) {
+            entry->address_cursor = (uint8_t)(address + 1);
+            return len;
+        }
+    }
+
+    return 0;
+}
+
+size_t isotp_router_can_tx(isotp_router_t* router, uint32_t* identifier, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS) {
+    //  Default to no separation
+    if(requested_separation_uS != NULL) { *requested_separation_uS = 0; }
+
+    //  Safety
+    if(router == NULL || router->entries == NULL || identifier == NULL || frame_data == NULL) {
+        return 0;
+    }
+
+    //  Round-robin from the slot after the last one that transmitted
+    const size_t mask = router->capacity - 1;
+    for(size_t i = 0; i < router->capacity; i++) {
+        size_t idx = (router->tx_cursor + i) & mask;
+        isotp_router_entry_t* entry = &router->entries[idx];
+
+        size_t len = 0;
+        if(entry->addressed != NULL) {
+            len = router_shared_can_tx(entry, frame_data, frame_size, requested_separation_uS);
+        }
+        else if(entry->session != NULL) {
+            len = isotp_session_can_tx(entry->session, frame_data, frame_size, requested_separation_uS);
+        }
+
+        if(len > 0) {
+            *identifier = entry->tx_id;
+            router->tx_cursor = (idx + 1) & mask;
+            return len;
+        }
+    }
+
+    //  Nothing to send
+    return 0;
+}
+
+uint64_t isotp_router_next_tx_due(const isotp_router_t* router) {
+    //  Safety
+    if(router == NULL || router->entries == NULL) {
+        return ISOTP_SESSION_DEADLINE_NONE;
+    }
+
+    uint64_t earliest = ISOTP_SESSION_DEADLINE_NONE;
+    for(size_t idx = 0; idx < router->capacity && earliest > 0; idx++) {
+        const isotp_router_entry_t* entry = &router->entries[idx];
+
+        //  Shared identifier: every attached session
+        if(entry->addressed != NULL) {
+            for(size_t address = 0; address < ISOTP_ROUTER_ADDRESS_COUNT && earliest > 0; address++) {
+                if(entry->addressed[address] == NULL) {
+                    continue;
+                }
+
+                uint64_t due = isotp_session_next_tx_due(entry->addressed[address]);
+                if(due < earliest) {
+                    earliest = due;
+                }
+            }
+
+            continue;
+        }
+
+        if(entry->session == NULL) {
+            continue;
+        }
+
+        uint64_t due = isotp_session_next_tx_due(entry->session);
+        if(due < earliest) {
+            earliest = due;
+        }
+    }
+
+    return earliest;
+}
+
+//  Batch consumer of `isotp_frame_queue_pump_router`
+static void router_queue_batch(void* context, const isotp_can_frame_t* frames, const size_t frame_count) {
+    isotp_router_can_rx_batch((isotp_router_t*)context, frames, frame_count);
+}
+
+size_t isotp_frame_queue_pump_router(isotp_frame_queue_t* queue, isotp_router_t* router, const size_t max_frames) {
+    //  Safety
+    if(queue == NULL || router == NULL) {
+        return 0;
+    }
+
+    return isotp_frame_queue_pump(queue, router_queue_batch, router, max_frames);
+}
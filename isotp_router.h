@@ -0,0 +1,180 @@
+#pragma once
+
+/*
+    ISO-TP Session Router
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Maps CAN arbitration IDs to sessions so a single receive path can serve many concurrent sessions.
+
+    Sessions are stored in a user provided open-addressing hash table keyed by the receive identifier.
+    Lookups are O(1) on average and the router never allocates memory.
+
+    With extended or mixed addressing many sessions share one identifier and are told apart by the address byte
+    that starts every frame. Such shared identifiers are registered with a user provided table of
+    `ISOTP_ROUTER_ADDRESS_COUNT` sessions indexed directly by that byte, so demultiplexing stays O(1).
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+#include "isotp_frame_queue.h"
+
+//  OR into an identifier to mark it as a 29-bit (extended) CAN identifier so 11-bit and 29-bit IDs never collide
+#define ISOTP_ROUTER_ID_FLAG_EXTENDED 0x80000000UL
+
+//  Sessions per shared identifier table (one per address byte value)
+#define ISOTP_ROUTER_ADDRESS_COUNT 256
+
+//  Router table slot
+typedef struct {
+	isotp_session_t* session;				//  Session frames are dispatched to (NULL = empty slot, unless `addressed` is set)
+	isotp_session_t** addressed;			//  Shared identifiers: sessions indexed by address byte (`ISOTP_ROUTER_ADDRESS_COUNT` entries), NULL otherwise
+	uint32_t rx_id;							//  Identifier the session receives on (lookup key)
+	uint32_t tx_id;							//  Identifier the session transmits on
+	uint8_t address_cursor;					//  (Live) Shared identifiers: address to resume from on the next `isotp_router_can_tx`
+} isotp_router_entry_t;
+
+//  ISO-TP session router
+typedef struct {
+	isotp_router_entry_t* entries;			//  User provided slot storage
+	size_t capacity;						//  Number of slots (power of two)
+	size_t count;							//  Number of registered identifiers
+	size_t tx_cursor;						//  (Live) Slot to resume from on the next `isotp_router_can_tx`
+} isotp_router_t;
+
+/**
+ * @brief Initializes a router over user provided slot storage. Keep the table at most ~75% full for best lookup times.
+ *
+ * @param router Router to initialize
+ * @param entries Slot storage
+ * @param capacity Number of slots in `entries` (must be a power of two)
+ * @return true Router initialized
+ * @return false Invalid parameters
+ */
+bool isotp_router_init(isotp_router_t* router, isotp_router_entry_t* entries, size_t capacity);
+
+/**
+ * @brief Registers a session with the router
+ *
+ * @param router Router to register with
+ * @param session Session to dispatch frames to
+ * @param rx_id Identifier the session receives on (OR with `ISOTP_ROUTER_ID_FLAG_EXTENDED` for 29-bit IDs)
+ * @param tx_id Identifier the session transmits on (OR with `ISOTP_ROUTER_ID_FLAG_EXTENDED` for 29-bit IDs)
+ * @return true Session registered
+ * @return false Router full or `rx_id` already registered
+ */
+bool isotp_router_add(isotp_router_t* router, isotp_session_t* session, const uint32_t rx_id, const uint32_t tx_id);
+
+/**
+ * @brief Registers an identifier shared by extended or mixed addressing sessions (see `isotp_router_attach`)
+ *
+ * @param router Router to register with
+ * @param sessions User provided table of `ISOTP_ROUTER_ADDRESS_COUNT` sessions, cleared on registration
+ * @param rx_id Identifier the sessions receive on (OR with `ISOTP_ROUTER_ID_FLAG_EXTENDED` for 29-bit IDs)
+ * @param tx_id Identifier the sessions transmit on (OR with `ISOTP_ROUTER_ID_FLAG_EXTENDED` for 29-bit IDs)
+ * @return true Identifier registered
+ * @return false Router full or `rx_id` already registered
+ */
+bool isotp_router_add_shared(isotp_router_t* router, isotp_session_t** sessions, const uint32_t rx_id, const uint32_t tx_id);
+
+/**
+ * @brief Attaches an extended or mixed addressing session to a shared identifier under its `rx_address`
+ *
+ * @param router Router to update
+ * @param session Session to dispatch frames carrying its `protocol_config.rx_address` to
+ * @param rx_id Shared identifier registered with `isotp_router_add_shared`
+ * @return true Session attached
+ * @return false `rx_id` is not shared, the session uses normal addressing or its address is taken
+ */
+bool isotp_router_attach(isotp_router_t* router, isotp_session_t* session, const uint32_t rx_id);
+
+/**
+ * @brief Detaches the session attached to a shared identifier under `address`
+ *
+ * @param router Router to update
+ * @param rx_id Shared identifier
+ * @param address Address byte the session was attached under
+ * @return true Session detached
+ * @return false `rx_id` is not shared or no session is attached under `address`
+ */
+bool isotp_router_detach(isotp_router_t* router, const uint32_t rx_id, const uint8_t address);
+
+/**
+ * @brief Removes the session or shared identifier registered on `rx_id`
+ *
+ * @param router Router to update
+ * @param rx_id Receive identifier of the session
+ * @return true Session removed
+ * @return false No session registered on `rx_id`
+ */
+bool isotp_router_remove(isotp_router_t* router, const uint32_t rx_id);
+
+/**
+ * @brief Looks up the slot registered on `rx_id`
+ *
+ * @param router Router to search
+ * @param rx_id Receive identifier
+ * @return isotp_router_entry_t* Matching slot, or NULL if not registered
+ */
+isotp_router_entry_t* isotp_router_find(const isotp_router_t* router, const uint32_t rx_id);
+
+/**
+ * @brief Dispatches a received CAN frame to the session registered on its identifier (and address byte, for shared identifiers)
+ *
+ * @param router Router to dispatch through
+ * @param identifier Arbitration ID the frame was received on
+ * @param frame_data Frame data
+ * @param frame_length Frame length
+ * @return true Frame was passed to a session
+ * @return false No session registered on `identifier` (or its address byte)
+ */
+bool isotp_router_can_rx(isotp_router_t* router, const uint32_t identifier, const uint8_t* frame_data, const size_t frame_length);
+
+/**
+ * @brief Dispatches an array of received CAN frames. Frames with the same identifier that arrive back-to-back are looked up once and handed to `isotp_session_can_rx_batch` together (split by address byte on shared identifiers).
+ *
+ * @param router Router to dispatch through
+ * @param frames Received frames (`identifier` selects the session), in bus order
+ * @param frame_count Number of frames
+ * @return size_t Number of frames passed to a session
+ */
+size_t isotp_router_can_rx_batch(isotp_router_t* router, const isotp_can_frame_t* frames, const size_t frame_count);
+
+/**
+ * @brief Fetches the next frame any registered session has to transmit. Sessions are polled round-robin so a long transfer cannot starve the others.
+ *
+ * @param router Router to poll
+ * @param identifier Outputted identifier the frame must be sent on
+ * @param frame_data Outputted frame data
+ * @param frame_size Size of frame allowed
+ * @param requested_separation_uS Outputted separation time requested by the session
+ * @return size_t Frame length (0 = nothing to send)
+ */
+size_t isotp_router_can_tx(isotp_router_t* router, uint32_t* identifier, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS);
+
+/**
+ * @brief Earliest time any registered session has a frame to send (see `isotp_session_next_tx_due`). Scans every slot.
+ *
+ * @param router Router to query
+ * @return uint64_t Due time (0 = now, ISOTP_SESSION_DEADLINE_NONE = nothing to send)
+ */
+uint64_t isotp_router_next_tx_due(const isotp_router_t* router);
+
+/**
+ * @brief Drains queued frames into a router with `isotp_router_can_rx_batch` (see isotp_frame_queue.h)
+ *
+ * @param queue Queue to drain
+ * @param router Router to feed
+ * @param max_frames Maximum frames to process in this call (0 = all queued)
+ * @return size_t Number of frames processed
+ */
+size_t isotp_frame_queue_pump_router(isotp_frame_queue_t* queue, isotp_router_t* router, const size_t max_frames);
+
+#ifdef __cplusplus
+}
+#endif
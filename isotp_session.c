@@ -2,7 +2,17 @@
 #include <string.h>
 #include "isotp_session.h"
 #include "isotp_conversions.h"
+#include "isotp_timer.h"
+#include "isotp_stats.h"
+#include "isotp_trace.h"
 
+//  Hot state must fit the first cache line (see `isotp_session_t`)
+_Static_assert(offsetof(isotp_session_t, user_context) + sizeof(void*) <= 64, "Hot session state spans more than one cache line");
+
+#ifdef ISOTP_SESSION_SHARED_OPS
+//  Table of sessions without one, so callbacks can be looked up without a check
+static const isotp_session_ops_t session_ops_none = { 0 };
+#endif
 
 //  Helper to decrement fc allowed frames
 void decrement_fc_allowed_frames(isotp_session_t* session) {
@@ -11,6 +21,209 @@ void decrement_fc_allowed_frames(isotp_session_t* session) {
     }
 }
 
+//  Full duplex: copies the live transfer fields out to `direction`
+static void duplex_save(const isotp_session_t* session, isotp_session_direction_t* direction) {
+    direction->state = session->state;
+    direction->fc_allowed_frames_remaining = session->fc_allowed_frames_remaining;
+    direction->fc_idx_track_consecutive = session->fc_idx_track_consecutive;
+    direction->fc_requested_block_size = session->fc_requested_block_size;
+    direction->fc_requested_separation_uS = session->fc_requested_separation_uS;
+    direction->full_transmission_length = session->full_transmission_length;
+    direction->rx_frame_size = session->rx_frame_size;
+    direction->tx_frame_size = session->tx_frame_size;
+    direction->buffer_offset = session->buffer_offset;
+    direction->tx_next_due_uS = session->tx_next_due_uS;
+    direction->fc_wait_count = session->fc_wait_count;
+}
+
+//  Full duplex: copies `direction` into the live transfer fields
+static void duplex_load(isotp_session_t* session, const isotp_session_direction_t* direction) {
+    session->state = direction->state;
+    session->fc_allowed_frames_remaining = direction->fc_allowed_frames_remaining;
+    session->fc_idx_track_consecutive = direction->fc_idx_track_consecutive;
+    session->fc_requested_block_size = direction->fc_requested_block_size;
+    session->fc_requested_separation_uS = direction->fc_requested_separation_uS;
+    session->full_transmission_length = direction->full_transmission_length;
+    session->rx_frame_size = direction->rx_frame_size;
+    session->tx_frame_size = direction->tx_frame_size;
+    session->buffer_offset = direction->buffer_offset;
+    session->tx_next_due_uS = direction->tx_next_due_uS;
+    session->fc_wait_count = direction->fc_wait_count;
+}
+
+//  Full duplex: exchanges the live transfer fields with the parked direction
+static void duplex_swap(isotp_session_t* session) {
+    isotp_session_direction_t live;
+    duplex_save(session, &live);
+    duplex_load(session, &session->duplex_parked);
+    session->duplex_parked = live;
+    session->duplex_rx_loaded = !session->duplex_rx_loaded;
+}
+
+//  Full duplex: loads the reception (`rx`) or transmission into the live fields while the session processes it. Returns the direction to restore with `duplex_leave`. No-op in half duplex.
+static bool duplex_enter(isotp_session_t* session, const bool rx) {
+    const bool previous = session->duplex_rx_loaded;
+    if(session->protocol_config.full_duplex) {
+        session->duplex_depth++;
+        if(previous != rx) { duplex_swap(session); }
+    }
+
+    return previous;
+}
+
+static void duplex_leave(isotp_session_t* session, const bool previous) {
+    if(session->protocol_config.full_duplex) {
+        session->duplex_depth--;
+        if(session->duplex_rx_loaded != previous) { duplex_swap(session); }
+    }
+}
+
+//  Helper to (re)arm a session timer, `delay_uS` is added to the configured timeout. Timers are disabled without a clock.
+static void timer_arm(isotp_session_t* session, const isotp_session_timer_t timer, const uint32_t delay_uS) {
+    //  Configured timeout
+    uint32_t timeout_uS = 0;
+    switch(timer) {
+        case ISOTP_SESSION_TIMER_N_AS:
+            timeout_uS = session->protocol_config.timeout_n_as_uS;
+            break;
+        case ISOTP_SESSION_TIMER_N_BS:
+            timeout_uS = session->protocol_config.timeout_n_bs_uS;
+            break;
+        case ISOTP_SESSION_TIMER_N_CR:
+            timeout_uS = session->protocol_config.timeout_n_cr_uS;
+            break;
+        case ISOTP_SESSION_TIMER_NONE:
+            break;
+    }
+
+    //  Arm or disarm
+    if(timeout_uS == 0 || ISOTP_SESSION_CALLBACK(session, callback_time_uS) == NULL) {
+        session->deadline_uS = ISOTP_SESSION_DEADLINE_NONE;
+        session->deadline_timer = ISOTP_SESSION_TIMER_NONE;
+    }
+    else {
+        session->deadline_uS = ISOTP_SESSION_CALLBACK(session, callback_time_uS)(ISOTP_SESSION_CONTEXT(session)) + timeout_uS + delay_uS;
+        session->deadline_timer = timer;
+    }
+
+    //  Full duplex: each direction keeps its own timer, the session expires at the earlier one
+    if(session->protocol_config.full_duplex) {
+        const size_t direction = session->duplex_rx_loaded ? 1 : 0;
+        session->duplex_deadline_uS[direction] = session->deadline_uS;
+        session->duplex_deadline_timer[direction] = session->deadline_timer;
+
+        const size_t earlier = (session->duplex_deadline_uS[1] < session->duplex_deadline_uS[0]) ? 1 : 0;
+        session->deadline_uS = session->duplex_deadline_uS[earlier];
+        session->deadline_timer = session->duplex_deadline_timer[earlier];
+    }
+
+    //  Keep heap ordered
+    if(session->timer_heap != NULL) { isotp_timer_heap_update(session->timer_heap, session); }
+}
+
+//  Helper to copy the next payload bytes of the current transmission into a frame
+static void tx_copy_payload(isotp_session_t* session, uint8_t* dest, size_t length) {
+    //  Owned tx buffer
+    if(session->tx_fragments == NULL) {
+        memcpy(dest, (const uint8_t*)session->tx_buffer + session->buffer_offset, length);
+        return;
+    }
+
+    //  Borrowed fragments, read sequentially
+    while(length > 0 && session->tx_fragment_idx < session->tx_fragment_count) {
+        const isotp_tx_fragment_t* fragment = &session->tx_fragments[session->tx_fragment_idx];
+        size_t available = fragment->length - session->tx_fragment_offset;
+        size_t chunk = (length < available) ? length : available;
+
+        memcpy(dest, fragment->data + session->tx_fragment_offset, chunk);
+        dest += chunk;
+        length -= chunk;
+        session->tx_fragment_offset += chunk;
+
+        //  Advance to next fragment
+        if(session->tx_fragment_offset >= fragment->length) {
+            session->tx_fragment_idx++;
+            session->tx_fragment_offset = 0;
+        }
+    }
+}
+
+//  Helper to store received payload bytes at the current buffer offset
+static bool rx_store_payload(isotp_session_t* session, const uint8_t* data, const size_t length) {
+    //  Streaming sink
+    if(session->rx_sink != NULL) {
+        return session->rx_sink->write(session->rx_sink->context, data, length, session->buffer_offset) >= length;
+    }
+
+    //  RX buffer
+    memcpy((uint8_t*)session->rx_buffer + session->buffer_offset, data, length);
+    return true;
+}
+
+//  Points `rx_buffer` at a slot the application does not hold, preferring the current one. Returns false when every slot is held.
+static bool rx_slot_claim(isotp_session_t* session) {
+    for(size_t i = 0; i < session->rx_slot_count; i++) {
+        const size_t idx = (session->rx_slot_idx + i) % session->rx_slot_count;
+        isotp_rx_slot_t* slot = &session->rx_slots[idx];
+
+        //  Pairs with the release in `isotp_session_release_rx`, which may run on another thread
+        if(!__atomic_load_n(&slot->held, __ATOMIC_ACQUIRE)) {
+            session->rx_slot_idx = idx;
+            session->rx_buffer = slot->buffer;
+            session->rx_len = slot->size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//  Lets the application (or the session's pool) select memory for the message starting. The pool always gets the
+//  session itself, whatever `user_context` is.
+static void rx_mem_assign(isotp_session_t* session) {
+    void (*callback_mem_assign) (void* context, const size_t indicated_length) = ISOTP_SESSION_CALLBACK(session, callback_mem_assign);
+    if(session->rx_pool_assign != NULL && (callback_mem_assign == NULL || callback_mem_assign == session->rx_pool_assign)) {
+        session->rx_pool_assign(session, session->full_transmission_length);
+    }
+    else if(callback_mem_assign != NULL) {
+        callback_mem_assign(ISOTP_SESSION_CONTEXT(session), session->full_transmission_length);
+    }
+}
+
+//  Reports a new message dropped because the application still holds the RX buffer (or every slot)
+static void rx_busy(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
+    ISOTP_STATS_INC(session, rx_busy);
+    ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_RX_BUSY, frame_data, frame_length);
+    if(ISOTP_SESSION_CALLBACK(session, callback_error_rx_busy) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_rx_busy)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
+}
+
+//  Hands a fully recieved message to the application. Slots and pool blocks stay held by it, reception continues into the next one.
+static void rx_deliver(isotp_session_t* session) {
+    //  Whether the message's memory moves to the application (otherwise single buffer or sink, held until the session is idled)
+    bool handed_over = false;
+    if(session->rx_sink == NULL) {
+        if(session->rx_slots != NULL && session->rx_buffer == session->rx_slots[session->rx_slot_idx].buffer) {
+            isotp_rx_slot_t* slot = &session->rx_slots[session->rx_slot_idx];
+            slot->length = session->full_transmission_length;
+
+            //  Held before the callback, so it may release the slot straight away
+            __atomic_store_n(&slot->held, true, __ATOMIC_RELEASE);
+            handed_over = true;
+        }
+        else if(session->rx_pool_block != NULL && session->rx_buffer == session->rx_pool_block) {
+            //  No longer freed by the next reception, the application releases it
+            session->rx_pool_block = NULL;
+            handed_over = true;
+        }
+    }
+
+    //  Callback
+    if(ISOTP_SESSION_CALLBACK(session, callback_transmission_rx) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_transmission_rx)(ISOTP_SESSION_CONTEXT(session)); }
+
+    //  Nothing left to wait for
+    if(handed_over && session->state == ISOTP_SESSION_RECEIVED) { isotp_session_idle(session); }
+}
+
 /*
 
     RX handlers
@@ -28,11 +241,13 @@ void handle_single_frame(isotp_session_t* session, const uint8_t* frame_data, co
     isotp_session_idle(session);
 
     //  Update session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_RECEIVING);
     session->state = ISOTP_SESSION_RECEIVING;
 
     //  Safety: ensure header exists (it should)
     if(frame_length < ISOTP_SPEC_FRAME_SINGLE_DATASTART_IDX) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
         else { isotp_session_idle(session); }
 
         return;
@@ -51,7 +266,8 @@ void handle_single_frame(isotp_session_t* session, const uint8_t* frame_data, co
     if(session->full_transmission_length == 0) {
         //  FD only works when protocol settings allow
         if(session->protocol_config.frame_format != ISOTP_FORMAT_FD) {
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
             else { isotp_session_idle(session); }
 
             return;
@@ -59,7 +275,8 @@ void handle_single_frame(isotp_session_t* session, const uint8_t* frame_data, co
 
         //  Length safety
         if(frame_length < ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX) {
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             return;
@@ -75,20 +292,30 @@ void handle_single_frame(isotp_session_t* session, const uint8_t* frame_data, co
         packet_len = frame_length - ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX;
     }
 
+    //  Receive slots: a slot the application does not hold
+    if(session->rx_slots != NULL && session->rx_sink == NULL && !rx_slot_claim(session)) {
+        isotp_session_idle(session);
+        rx_busy(session, frame_data, frame_length);
+        return;
+    }
+
     //  Allow user to assign memory if desired
-    if(session->callback_mem_assign != NULL) { session->callback_mem_assign(session, session->full_transmission_length); }
+    rx_mem_assign(session);
 
     //  Safety for length byte being at least length of msg_length
     if(packet_len < session->full_transmission_length) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
         else { isotp_session_idle(session); }
         
         return;
     }
 
-    //  Safety for buffer being large enough
-    if(session->full_transmission_length > session->rx_len) {
-        if(session->callback_error_transmission_too_large != NULL) { session->callback_error_transmission_too_large(session, packet_start, packet_len, session->full_transmission_length); }
+    //  Safety for buffer being large enough (sinks are unbounded)
+    if(session->rx_sink == NULL && session->full_transmission_length > session->rx_len) {
+        ISOTP_STATS_INC(session, too_large);
+        ISOTP_TRACE_VALUE(session, ISOTP_TRACE_ERROR, ISOTP_TRACE_ERROR_TOO_LARGE, session->full_transmission_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->full_transmission_length); }
         else { isotp_session_idle(session); }
 
         return;
@@ -96,25 +323,35 @@ void handle_single_frame(isotp_session_t* session, const uint8_t* frame_data, co
 
     //  Safety: Ensure we have enough data in the frame for the indicated length
     if(session->full_transmission_length > packet_len) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
         else { isotp_session_idle(session); }
 
         return;
     }
 
     //  Load data into buffer
-    memcpy(session->rx_buffer, packet_start, session->full_transmission_length);
+    if(!rx_store_payload(session, packet_start, session->full_transmission_length)) {
+        ISOTP_STATS_INC(session, too_large);
+        ISOTP_TRACE_VALUE(session, ISOTP_TRACE_ERROR, ISOTP_TRACE_ERROR_TOO_LARGE, session->full_transmission_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->full_transmission_length); }
+        else { isotp_session_idle(session); }
+
+        return;
+    }
 
     //  Update session
     session->buffer_offset += session->full_transmission_length;
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_RECEIVED);
     session->state = ISOTP_SESSION_RECEIVED;
+    ISOTP_STATS_ADD(session, bytes_rx, session->full_transmission_length);
+    ISOTP_STATS_INC(session, transfers_rx);
 
     //  Peek
-    if(session->callback_peek_first_frame != NULL) { session->callback_peek_first_frame(session, packet_start, session->full_transmission_length); }
+    if(ISOTP_SESSION_CALLBACK(session, callback_peek_first_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_peek_first_frame)(ISOTP_SESSION_CONTEXT(session), packet_start, session->full_transmission_length); }
     
     //  Callback
-    if(session->callback_transmission_rx != NULL) { session->callback_transmission_rx(session); }
-    //if(session->state == ISOTP_SESSION_RECEIVED) { isotp_session_idle(session); }
+    rx_deliver(session);
 }
 
 void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
@@ -127,11 +364,13 @@ void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, con
     isotp_session_idle(session);
 
     //  Update session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_RECEIVING);
     session->state = ISOTP_SESSION_RECEIVING;
 
     //  Safety: ensure header exists
     if(frame_length < ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
         else { isotp_session_idle(session); }
         
         return;
@@ -152,7 +391,8 @@ void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, con
     if(session->full_transmission_length == 0) {
         //  FD only works when protocol settings allow
         if(session->protocol_config.frame_format != ISOTP_FORMAT_FD) {
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_SINGLE, frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             return;
@@ -160,7 +400,8 @@ void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, con
 
         //  Length safety
         if (frame_length < ISOTP_SPEC_FRAME_FIRST_FD_DATASTART_IDX) {
-            if (session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if (ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
             else { isotp_session_idle(session); }
 
             return;
@@ -169,7 +410,7 @@ void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, con
         //  Extract expected length using CAN-FD spec
         session->full_transmission_length = 0;
         for (size_t i = ISOTP_SPEC_FRAME_FIRST_FD_MSB_IDX; i <= ISOTP_SPEC_FRAME_FIRST_FD_LSB_IDX; ++i) {
-            session->full_transmission_length |= frame_data[i] << (8 * (ISOTP_SPEC_FRAME_FIRST_FD_LSB_IDX - i));
+            session->full_transmission_length |= (size_t)frame_data[i] << (8 * (ISOTP_SPEC_FRAME_FIRST_FD_LSB_IDX - i));
         }
 
         //  Update start pointer
@@ -179,31 +420,59 @@ void handle_first_frame(isotp_session_t* session, const uint8_t* frame_data, con
         packet_len = frame_length - ISOTP_SPEC_FRAME_FIRST_FD_DATASTART_IDX;
     }
 
-    //  Safety for buffer being large enough
-    if(session->full_transmission_length > session->rx_len) {
-        if(session->callback_error_transmission_too_large != NULL) { session->callback_error_transmission_too_large(session, packet_start, packet_len, session->full_transmission_length); }
-        else { isotp_session_idle(session); }
-
+    //  Receive slots: a slot the application does not hold
+    if(session->rx_slots != NULL && session->rx_sink == NULL && !rx_slot_claim(session)) {
+        isotp_session_idle(session);
+        rx_busy(session, frame_data, frame_length);
         return;
     }
 
-    //  Safety: Ensure packet_len doesn't exceed rx buffer size
-    if(packet_len > session->rx_len) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_FIRST, frame_data, frame_length); }
+    //  Allow user to assign memory (or a sink) if desired
+    rx_mem_assign(session);
+
+    //  Sinks are unbounded, only the RX buffer needs size checks
+    if(session->rx_sink == NULL) {
+        //  Safety for buffer being large enough
+        if(session->full_transmission_length > session->rx_len) {
+            ISOTP_STATS_INC(session, too_large);
+            ISOTP_TRACE_VALUE(session, ISOTP_TRACE_ERROR, ISOTP_TRACE_ERROR_TOO_LARGE, session->full_transmission_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->full_transmission_length); }
+            else { isotp_session_idle(session); }
+
+            return;
+        }
+
+        //  Safety: Ensure packet_len doesn't exceed rx buffer size
+        if(packet_len > session->rx_len) {
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_FIRST, frame_data, frame_length); }
+            else { isotp_session_idle(session); }
+
+            return;
+        }
+    }
+
+    //  Load data into buffer
+    if(!rx_store_payload(session, packet_start, packet_len)) {
+        ISOTP_STATS_INC(session, too_large);
+        ISOTP_TRACE_VALUE(session, ISOTP_TRACE_ERROR, ISOTP_TRACE_ERROR_TOO_LARGE, session->full_transmission_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->full_transmission_length); }
         else { isotp_session_idle(session); }
 
         return;
     }
 
-    //  Load data into buffer
-    memcpy(session->rx_buffer, packet_start, packet_len);
+    //  Consecutive frames use the data length of the first frame
+    session->rx_frame_size = frame_length;
 
     //  Update session
     session->buffer_offset += packet_len;
+    ISOTP_STATS_ADD(session, bytes_rx, packet_len);
     decrement_fc_allowed_frames(session);   //  Will queue FC delay if configured
+    timer_arm(session, ISOTP_SESSION_TIMER_N_CR, 0);
 
     //  Callback
-    if(session->callback_peek_first_frame != NULL) { session->callback_peek_first_frame(session, packet_start, packet_len); }
+    if(ISOTP_SESSION_CALLBACK(session, callback_peek_first_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_peek_first_frame)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len); }
 }
 
 void handle_consecutive_frame(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
@@ -214,7 +483,8 @@ void handle_consecutive_frame(isotp_session_t* session, const uint8_t* frame_dat
 
     // Safety: session state
     if (session->state != ISOTP_SESSION_RECEIVING) {
-        if (session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+        if (ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
         else { isotp_session_idle(session); }
 
         return;
@@ -222,7 +492,8 @@ void handle_consecutive_frame(isotp_session_t* session, const uint8_t* frame_dat
 
     // Safety: ensure header exists
     if (frame_length < ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX) {
-        if (session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if (ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
         else { isotp_session_idle(session); }
         
         return;
@@ -233,7 +504,10 @@ void handle_consecutive_frame(isotp_session_t* session, const uint8_t* frame_dat
 
     // Verify the received index matches the expected index
     if (index != session->fc_idx_track_consecutive) {
-        if (session->callback_error_consecutive_out_of_order != NULL) { session->callback_error_consecutive_out_of_order(session, frame_data, frame_length, session->fc_idx_track_consecutive, index); }
+        session->rx_sequence_errors++;
+        ISOTP_STATS_INC(session, out_of_order);
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_OUT_OF_ORDER, ((const uint8_t[]){ session->fc_idx_track_consecutive, index }), 2);
+        if (ISOTP_SESSION_CALLBACK(session, callback_error_consecutive_out_of_order) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_consecutive_out_of_order)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length, session->fc_idx_track_consecutive, index); }
         else { isotp_session_idle(session); }
         return;
     }
@@ -252,39 +526,50 @@ void handle_consecutive_frame(isotp_session_t* session, const uint8_t* frame_dat
     const uint8_t* packet_start = frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
     size_t bytes_remaining = session->full_transmission_length - session->buffer_offset;
 
+    //  Ignore padding past the end of the transmission
+    if (packet_len > bytes_remaining) {
+        packet_len = bytes_remaining;
+    }
+
     //  Safety: Ensure we don't exceed rx buffer size
-    size_t buffer_space_remaining = session->rx_len - session->buffer_offset;
-    if (packet_len > buffer_space_remaining) {
-        if (session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, ISOTP_SPEC_FRAME_CONSECUTIVE, frame_data, frame_length); }
+    if (session->rx_sink == NULL && packet_len > session->rx_len - session->buffer_offset) {
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+        if (ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), ISOTP_SPEC_FRAME_CONSECUTIVE, frame_data, frame_length); }
         else { isotp_session_idle(session); }
 
         return;
     }
 
-    //  Add to buffer
-    if (packet_len > bytes_remaining) {
-        packet_len = bytes_remaining;
-    }
-
     //  Copy data
-    memcpy((uint8_t*)session->rx_buffer + session->buffer_offset, packet_start, packet_len);
+    if (!rx_store_payload(session, packet_start, packet_len)) {
+        ISOTP_STATS_INC(session, too_large);
+        ISOTP_TRACE_VALUE(session, ISOTP_TRACE_ERROR, ISOTP_TRACE_ERROR_TOO_LARGE, session->full_transmission_length);
+        if (ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_transmission_too_large)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->full_transmission_length); }
+        else { isotp_session_idle(session); }
+
+        return;
+    }
 
     //  Update session
     session->buffer_offset += packet_len;
+    ISOTP_STATS_ADD(session, bytes_rx, packet_len);
+    timer_arm(session, ISOTP_SESSION_TIMER_N_CR, 0);
 
     //  Peek callback
-    if (session->callback_peek_consecutive_frame != NULL) {
-        session->callback_peek_consecutive_frame(session, packet_start, packet_len, session->buffer_offset - packet_len);
+    if (ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame) != NULL) {
+        ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame)(ISOTP_SESSION_CONTEXT(session), packet_start, packet_len, session->buffer_offset - packet_len);
     }
 
     // Check if transmission is complete
     if (session->buffer_offset >= session->full_transmission_length) {
         //  Update state
+        ISOTP_TRACE_STATE(session, ISOTP_SESSION_RECEIVED);
         session->state = ISOTP_SESSION_RECEIVED;
+        ISOTP_STATS_INC(session, transfers_rx);
+        timer_arm(session, ISOTP_SESSION_TIMER_NONE, 0);
 
         //  Callback
-        if(session->callback_transmission_rx != NULL) { session->callback_transmission_rx(session); }
-        //if(session->state == ISOTP_SESSION_RECEIVED) { isotp_session_idle(session); }
+        rx_deliver(session);
     }
 }
 
@@ -296,7 +581,8 @@ void handle_flow_control_frame(isotp_session_t* session, const uint8_t* frame_da
 
     //  Safety: session state
     if(session->state != ISOTP_SESSION_TRANSMITTING_AWAITING_FC && session->state != ISOTP_SESSION_TRANSMITTING) {
-        if(session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
         else { isotp_session_idle(session); }
         
         return;
@@ -305,15 +591,16 @@ void handle_flow_control_frame(isotp_session_t* session, const uint8_t* frame_da
     //  LIN does not use FC
     if(session->protocol_config.frame_format == ISOTP_FORMAT_LIN) {
         //  Unexpected frame
-        if(session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
         else { isotp_session_idle(session); }
         
         return;
     }
 
     //  Peek callback
-    if (session->callback_peek_flow_control_frame != NULL) {
-        session->callback_peek_flow_control_frame(session);
+    if (ISOTP_SESSION_CALLBACK(session, callback_peek_flow_control_frame) != NULL) {
+        ISOTP_SESSION_CALLBACK(session, callback_peek_flow_control_frame)(ISOTP_SESSION_CONTEXT(session));
     }
 
     //  Read FC flags
@@ -331,25 +618,33 @@ void handle_flow_control_frame(isotp_session_t* session, const uint8_t* frame_da
         separation_time = isotp_spec_fc_separation_time_us(frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_IDX] & ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_MASK);
     }
 
+    ISOTP_TRACE_FC(session, ISOTP_TRACE_FC_RX, fc_flags, block_size, separation_time);
+
     //  Process FC frame
     switch(fc_flags) {
         case ISOTP_SPEC_FC_FLAG_CONTINUE_TO_SEND:
             //  Continue transmission
+            ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING);
             session->state = ISOTP_SESSION_TRANSMITTING;
             break;
         case ISOTP_SPEC_FC_FLAG_WAIT:
             //  Wait
+            ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING_AWAITING_FC);
             session->state = ISOTP_SESSION_TRANSMITTING_AWAITING_FC;
+            ISOTP_STATS_INC(session, fc_wait_rx);
             break;
         case ISOTP_SPEC_FC_FLAG_OVERFLOW_ABORT:
             //  Abort transmission
-            if(session->callback_error_partner_aborted_transfer != NULL) { session->callback_error_partner_aborted_transfer(session, frame_data, frame_length); }
+            ISOTP_STATS_INC(session, fc_overflow_rx);
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_PARTNER_ABORTED, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_partner_aborted_transfer) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_partner_aborted_transfer)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
-            break;
+            return;
         default:
             //  Invalid FC flags
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             return;
@@ -363,6 +658,9 @@ void handle_flow_control_frame(isotp_session_t* session, const uint8_t* frame_da
     if(session->fc_allowed_frames_remaining == 0) {
         session->fc_allowed_frames_remaining = UINT16_MAX;
     }
+
+    //  Restart sender timer
+    timer_arm(session, (session->state == ISOTP_SESSION_TRANSMITTING) ? ISOTP_SESSION_TIMER_N_AS : ISOTP_SESSION_TIMER_N_BS, 0);
 }
 
 /*
@@ -387,13 +685,15 @@ void rx_idle(const isotp_spec_frame_type_t frame_type, isotp_session_t* session,
         case ISOTP_SPEC_FRAME_CONSECUTIVE:
         case ISOTP_SPEC_FRAME_FLOW_CONTROL:
             //  Unexpected frame
-            if(session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             break;
         default:
             //  Invalid frame type
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, frame_type, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), frame_type, frame_data, frame_length); }
             else { isotp_session_idle(session); }
            
             break;
@@ -414,7 +714,8 @@ void rx_transmitting(const isotp_spec_frame_type_t frame_type, isotp_session_t*
             break;
         case ISOTP_SPEC_FRAME_CONSECUTIVE:
             //  Unexpected frame
-            if(session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             break;
@@ -424,7 +725,8 @@ void rx_transmitting(const isotp_spec_frame_type_t frame_type, isotp_session_t*
             break;
         default:
             //  Invalid frame type
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, frame_type, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), frame_type, frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             break;
@@ -447,13 +749,15 @@ void rx_receiving(const isotp_spec_frame_type_t frame_type, isotp_session_t* ses
             break;
         case ISOTP_SPEC_FRAME_FLOW_CONTROL:
             //  Unexpected frame
-            if(session->callback_error_unexpected_frame_type != NULL) { session->callback_error_unexpected_frame_type(session, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             break;
         default:
             //  Invalid frame type
-            if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, frame_type, frame_data, frame_length); }
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), frame_type, frame_data, frame_length); }
             else { isotp_session_idle(session); }
             
             break;
@@ -461,8 +765,27 @@ void rx_receiving(const isotp_spec_frame_type_t frame_type, isotp_session_t* ses
 }
 
 void rx_received(const isotp_spec_frame_type_t frame_type, isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
-    //  Program has not yet handled RX buffer
-    //  We need to have a callback and return a busy error
+    //  Program has not yet handled RX buffer, which must never be discarded on its behalf (no idle fallbacks)
+    switch(frame_type) {
+        case ISOTP_SPEC_FRAME_SINGLE:
+        case ISOTP_SPEC_FRAME_FIRST:
+            //  New message with nowhere to go
+            rx_busy(session, frame_data, frame_length);
+            break;
+        case ISOTP_SPEC_FRAME_CONSECUTIVE:
+        case ISOTP_SPEC_FRAME_FLOW_CONTROL:
+            //  Unexpected frame
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_UNEXPECTED_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_unexpected_frame_type)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
+
+            break;
+        default:
+            //  Invalid frame type
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, frame_data, frame_length);
+            if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), frame_type, frame_data, frame_length); }
+
+            break;
+    }
 }
 
 void isotp_session_can_rx(isotp_session_t* session, const uint8_t* data, const size_t length) {
@@ -470,37 +793,155 @@ void isotp_session_can_rx(isotp_session_t* session, const uint8_t* data, const s
     if(session == NULL || data == NULL || length == 0) {
         return;
     }
-    
-    //  Callback
-    if(session->callback_can_rx != NULL) { session->callback_can_rx(session, data, length); }
 
-    //  ISO-TP Frames must be at least a byte
-    if(length < 1) {
-        if(session->callback_error_invalid_frame != NULL) { session->callback_error_invalid_frame(session, (isotp_spec_frame_type_t)0xFF, data, length); }
+    //  Extended & mixed addressing: frames carrying another address are not part of this session
+    const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+    if(address_offset > 0 && data[ISOTP_SPEC_FRAME_ADDRESS_IDX] != session->protocol_config.rx_address) {
+        return;
+    }
+
+    //  Full duplex: flow control frames belong to the transmission, all other frames to the reception
+    const bool rx_direction = length <= address_offset || ((data[address_offset + ISOTP_SPEC_FRAME_TYPE_IDX] & ISOTP_SPEC_FRAME_TYPE_MASK) >> ISOTP_SPEC_FRAME_TYPE_SHIFT) != ISOTP_SPEC_FRAME_FLOW_CONTROL;
+    const bool previous = duplex_enter(session, rx_direction);
+    
+    //  Callback & trace
+    if(ISOTP_SESSION_CALLBACK(session, callback_can_rx) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_can_rx)(ISOTP_SESSION_CONTEXT(session), data, length); }
+    ISOTP_TRACE(session, ISOTP_TRACE_FRAME_RX, length, data, length);
+
+    //  ISO-TP Frames must be at least a byte after the address
+    if(length < address_offset + 1) {
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_INVALID_FRAME, data, length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_invalid_frame)(ISOTP_SESSION_CONTEXT(session), (isotp_spec_frame_type_t)0xFF, data, length); }
         else { isotp_session_idle(session); }
         
+        duplex_leave(session, previous);
         return;
     }
 
+    //  Handlers parse the frame from its protocol control information on
+    const uint8_t* frame_data = data + address_offset;
+    const size_t frame_length = length - address_offset;
+
     //  Determine frame type
-    isotp_spec_frame_type_t frame_type = (isotp_spec_frame_type_t)((data[ISOTP_SPEC_FRAME_TYPE_IDX] & ISOTP_SPEC_FRAME_TYPE_MASK) >> ISOTP_SPEC_FRAME_TYPE_SHIFT);
+    isotp_spec_frame_type_t frame_type = (isotp_spec_frame_type_t)((frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] & ISOTP_SPEC_FRAME_TYPE_MASK) >> ISOTP_SPEC_FRAME_TYPE_SHIFT);
+
+    //  Count by type
+    if(frame_type <= ISOTP_SPEC_FRAME_FLOW_CONTROL) { ISOTP_STATS_INC(session, frames_rx[frame_type]); }
+    else { ISOTP_STATS_INC(session, frames_rx_invalid); }
     
     //  Process frame based on session state
     switch(session->state) {
         case ISOTP_SESSION_IDLE:
-            rx_idle(frame_type, session, data, length);
+            rx_idle(frame_type, session, frame_data, frame_length);
             break;
         case ISOTP_SESSION_TRANSMITTING:
         case ISOTP_SESSION_TRANSMITTING_AWAITING_FC:
-            rx_transmitting(frame_type, session, data, length);
+            rx_transmitting(frame_type, session, frame_data, frame_length);
             break;
         case ISOTP_SESSION_RECEIVING:
-            rx_receiving(frame_type, session, data, length);
+            rx_receiving(frame_type, session, frame_data, frame_length);
             break;
         case ISOTP_SESSION_RECEIVED:
-            rx_received(frame_type, session, data, length);
+            rx_received(frame_type, session, frame_data, frame_length);
             break;
     }
+
+    duplex_leave(session, previous);
+}
+
+//  Batch fast path: stores a run of in-order consecutive frames straight into the RX buffer. Returns frames consumed.
+static size_t rx_consecutive_run(isotp_session_t* session, const isotp_can_frame_t* frames, const size_t frame_count) {
+    //  Sinks and foreign states go through the regular handlers
+    if(session->state != ISOTP_SESSION_RECEIVING || session->rx_sink != NULL) {
+        return 0;
+    }
+
+    const size_t run_start = session->buffer_offset;
+    const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+    size_t consumed = 0;
+
+    while(consumed < frame_count) {
+        const isotp_can_frame_t* frame = &frames[consumed];
+        const uint8_t* pci = frame->data + address_offset;
+
+        //  Only in-order consecutive frames for this session's address qualify
+        if(frame->length <= address_offset + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX) {
+            break;
+        }
+
+        if(address_offset > 0 && frame->data[ISOTP_SPEC_FRAME_ADDRESS_IDX] != session->protocol_config.rx_address) {
+            break;
+        }
+
+        const uint8_t header = pci[ISOTP_SPEC_FRAME_TYPE_IDX];
+        if(((header & ISOTP_SPEC_FRAME_TYPE_MASK) >> ISOTP_SPEC_FRAME_TYPE_SHIFT) != ISOTP_SPEC_FRAME_CONSECUTIVE ||
+           (header & ISOTP_SPEC_FRAME_CONSECUTIVE_INDEX_MASK) != session->fc_idx_track_consecutive) {
+            break;
+        }
+
+        //  The final frame completes the transmission through the regular handler
+        const size_t packet_len = frame->length - address_offset - ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
+        if(packet_len >= session->full_transmission_length - session->buffer_offset || packet_len > session->rx_len - session->buffer_offset) {
+            break;
+        }
+
+        //  Callback & trace, raw frame hooks stay per frame
+        if(ISOTP_SESSION_CALLBACK(session, callback_can_rx) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_can_rx)(ISOTP_SESSION_CONTEXT(session), frame->data, frame->length); }
+        ISOTP_TRACE(session, ISOTP_TRACE_FRAME_RX, frame->length, frame->data, frame->length);
+
+        //  Copy data
+        memcpy((uint8_t*)session->rx_buffer + session->buffer_offset, pci + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, packet_len);
+        session->buffer_offset += packet_len;
+
+        //  Increment expected index and handle rollover
+        session->fc_idx_track_consecutive++;
+        if(session->fc_idx_track_consecutive > session->protocol_config.consecutive_index_end) {
+            session->fc_idx_track_consecutive = session->protocol_config.consecutive_index_start;
+        }
+
+        //  Decrement flow control counter
+        decrement_fc_allowed_frames(session);
+
+        consumed++;
+    }
+
+    //  Restart reciever timer
+    if(consumed > 0) {
+        ISOTP_STATS_ADD(session, frames_rx[ISOTP_SPEC_FRAME_CONSECUTIVE], consumed);
+        ISOTP_STATS_ADD(session, bytes_rx, session->buffer_offset - run_start);
+        timer_arm(session, ISOTP_SESSION_TIMER_N_CR, 0);
+    }
+
+    //  Single peek callback covering the whole run (not the whole transmission, a run ends with the batch)
+    if(consumed > 0 && ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame) != NULL) {
+        ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame)(ISOTP_SESSION_CONTEXT(session), (const uint8_t*)session->rx_buffer + run_start, session->buffer_offset - run_start, run_start);
+    }
+
+    return consumed;
+}
+
+void isotp_session_can_rx_batch(isotp_session_t* session, const isotp_can_frame_t* frames, const size_t frame_count) {
+    //  Safety
+    if(session == NULL || frames == NULL) {
+        return;
+    }
+
+    size_t idx = 0;
+    while(idx < frame_count) {
+        //  Fast path for runs of consecutive frames
+        const bool previous = duplex_enter(session, true);
+        size_t consumed = rx_consecutive_run(session, frames + idx, frame_count - idx);
+        duplex_leave(session, previous);
+
+        if(consumed > 0) {
+            idx += consumed;
+            continue;
+        }
+
+        //  Regular processing
+        isotp_session_can_rx(session, frames[idx].data, frames[idx].length);
+        idx++;
+    }
 }
 
 /*
@@ -508,14 +949,31 @@ void isotp_session_can_rx(isotp_session_t* session, const uint8_t* data, const s
     CAN Transmission
 
 */
-size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS) {
+size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, size_t frame_size, uint32_t* requested_separation_uS) {
     //  Verify we are transmitting
     if(session->state != ISOTP_SESSION_TRANSMITTING) {
         return 0;
     }
 
+    //  CAN FD: frame size planned with the first frame, consecutive frames must keep it
+    if(session->protocol_config.fd_tx_dl_planned && session->protocol_config.frame_format == ISOTP_FORMAT_FD) {
+        if(session->buffer_offset == 0) {
+            const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+            session->tx_frame_size = isotp_spec_fd_plan_frame_size(session->full_transmission_length, frame_size + address_offset, address_offset, session->protocol_config.fd_header_force, session->protocol_config.padding_enabled, ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES) - address_offset;
+        }
+
+        if(session->tx_frame_size != 0 && session->tx_frame_size < frame_size) {
+            frame_size = session->tx_frame_size;
+        }
+    }
+
+    //  Separation time not yet passed
+    if(session->tx_next_due_uS != 0 && ISOTP_SESSION_CALLBACK(session, callback_time_uS) != NULL && ISOTP_SESSION_CALLBACK(session, callback_time_uS)(ISOTP_SESSION_CONTEXT(session)) < session->tx_next_due_uS) {
+        return 0;
+    }
+
     //  Return
-    if(requested_separation_uS != NULL) { *requested_separation_uS = 0; }
+    uint32_t separation_uS = 0;
     size_t ret_frame_size = 0;
 
     //  First frame?
@@ -523,8 +981,11 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
     {
         //  Can we fit this in a single frame?
         size_t single_frame_available_bytes = frame_size - ISOTP_SPEC_FRAME_SINGLE_DATASTART_IDX;
+
+        //  The 4 bit length only covers frames up to 8 bytes, including any address byte
+        const size_t fd_enable_len = ISOTP_SPEC_FRAME_SINGLE_FD_ENABLE_LEN - ISOTP_SESSION_ADDRESS_OFFSET(session);
         
-        bool use_fd_header = session->protocol_config.fd_header_force || session->full_transmission_length >= ISOTP_SPEC_FRAME_SINGLE_FD_ENABLE_LEN;
+        bool use_fd_header = session->protocol_config.fd_header_force || session->full_transmission_length >= fd_enable_len;
         if(use_fd_header) {
             single_frame_available_bytes = frame_size - ISOTP_SPEC_FRAME_SINGLE_FD_DATASTART_IDX;
         }
@@ -543,7 +1004,7 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
 
             switch(session->protocol_config.frame_format) {
                 case ISOTP_FORMAT_FD:
-                    if(session->protocol_config.fd_header_force || session->full_transmission_length >= ISOTP_SPEC_FRAME_SINGLE_FD_ENABLE_LEN) {
+                    if(use_fd_header) {
                         //  Insert length
                         frame_data[ISOTP_SPEC_FRAME_SINGLE_FD_LEN_IDX] = session->full_transmission_length;
                         
@@ -564,17 +1025,18 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
             }
 
             //  Retrieval parameters
-            const uint8_t* packet_start = (uint8_t*)session->tx_buffer;
             const size_t packet_len = session->full_transmission_length;
 
             //  Copy data
-            memcpy(frame_start, packet_start, packet_len);
+            tx_copy_payload(session, frame_start, packet_len);
+
+            //  Advance buffer (concludes transmission below)
+            session->buffer_offset += packet_len;
+            ISOTP_STATS_INC(session, frames_tx[ISOTP_SPEC_FRAME_SINGLE]);
+            ISOTP_STATS_ADD(session, bytes_tx, packet_len);
 
             //  Send frame data
             ret_frame_size = header_size + packet_len;
-
-            //  Conclude transmission
-            isotp_session_idle(session);
         }
         else 
         {
@@ -588,7 +1050,6 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
 
             //  Setup parameters
             uint8_t* frame_start = frame_data + ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX;
-            const uint8_t* packet_start = (uint8_t*)session->tx_buffer;
             size_t packet_len = frame_size - ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX;
             size_t header_len = ISOTP_SPEC_FRAME_FIRST_DATASTART_IDX;
 
@@ -620,10 +1081,12 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
             }
 
             //  Copy data
-            memcpy(frame_start, packet_start, packet_len);
+            tx_copy_payload(session, frame_start, packet_len);
 
             //  Advance buffer
             session->buffer_offset += packet_len;
+            ISOTP_STATS_INC(session, frames_tx[ISOTP_SPEC_FRAME_FIRST]);
+            ISOTP_STATS_ADD(session, bytes_tx, packet_len);
 
             //  Send frame data
             ret_frame_size = header_len + packet_len;
@@ -639,7 +1102,6 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
         frame_data[ISOTP_SPEC_FRAME_CONSECUTIVE_INDEX_IDX] |= session->fc_idx_track_consecutive & ISOTP_SPEC_FRAME_CONSECUTIVE_INDEX_MASK;
 
         //  Setup parameters
-        const uint8_t* packet_start = (uint8_t*)session->tx_buffer + session->buffer_offset;
         const size_t bytes_remaining = session->full_transmission_length - session->buffer_offset;
 
         //  Calculate packet length
@@ -649,10 +1111,12 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
         }
 
         //  Copy data
-        memcpy(frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, packet_start, packet_len);
+        tx_copy_payload(session, frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, packet_len);
 
         //  Advance buffer
         session->buffer_offset += packet_len;
+        ISOTP_STATS_INC(session, frames_tx[ISOTP_SPEC_FRAME_CONSECUTIVE]);
+        ISOTP_STATS_ADD(session, bytes_tx, packet_len);
 
         //  Increment expected index
         session->fc_idx_track_consecutive++;
@@ -661,7 +1125,7 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
         }
 
         //  Desired separation time
-        if(requested_separation_uS != NULL) { *requested_separation_uS = session->fc_requested_separation_uS; }
+        separation_uS = session->fc_requested_separation_uS;
 
         //  Send frame data
         ret_frame_size = packet_len + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
@@ -672,14 +1136,32 @@ size_t tx_transmitting(isotp_session_t* session, uint8_t* frame_data, const size
 
     //  Check if we need to enter flow control wait mode (LIN does not have FC)
     if(session->fc_allowed_frames_remaining == 0 && session->protocol_config.frame_format != ISOTP_FORMAT_LIN) {
+        ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING_AWAITING_FC);
         session->state = ISOTP_SESSION_TRANSMITTING_AWAITING_FC;
     }
 
+    //  Desired separation time
+    if(requested_separation_uS != NULL) { *requested_separation_uS = separation_uS; }
+
     //  Check if done
     if(session->buffer_offset >= session->full_transmission_length) {
         //  Done
+        ISOTP_STATS_INC(session, transfers_tx);
         isotp_session_idle(session);
     }
+    else if(session->state == ISOTP_SESSION_TRANSMITTING_AWAITING_FC) {
+        //  Restart sender timer
+        timer_arm(session, ISOTP_SESSION_TIMER_N_BS, 0);
+    }
+    else {
+        //  Restart sender timer (separation time does not count against the sender)
+        timer_arm(session, ISOTP_SESSION_TIMER_N_AS, separation_uS);
+
+        //  Hold the next frame until separation time has passed
+        if(separation_uS > 0 && ISOTP_SESSION_CALLBACK(session, callback_time_uS) != NULL) {
+            session->tx_next_due_uS = ISOTP_SESSION_CALLBACK(session, callback_time_uS)(ISOTP_SESSION_CONTEXT(session)) + separation_uS;
+        }
+    }
 
     //  Return
     return ret_frame_size;
@@ -701,58 +1183,215 @@ size_t tx_recieving(isotp_session_t* session, uint8_t* frame_data, const size_t
     }
 
     //  When recieving, we just need to check if a flow control frame is needed
-    if(session->fc_allowed_frames_remaining == 0) {
-        //  Send flow control frame
-        //  TODO: Add ability to wait and abort?
-        isotp_flow_control_flags_t fc_flag = ISOTP_SPEC_FC_FLAG_CONTINUE_TO_SEND;
+    if(session->fc_allowed_frames_remaining != 0) {
+        return 0;
+    }
 
-        //  Reset block size and request configured number of frames
-        session->fc_allowed_frames_remaining = session->fc_requested_block_size;
-        if(session->fc_allowed_frames_remaining == 0) {
-            session->fc_allowed_frames_remaining = UINT16_MAX;
-        }
-        
-        //  Seperation time
-        uint8_t seperation_time = isotp_spec_fc_separation_time_byte(session->fc_requested_separation_uS);
+    //  Previous FC WAIT interval not yet passed
+    if(session->tx_next_due_uS != 0 && ISOTP_SESSION_CALLBACK(session, callback_time_uS) != NULL && ISOTP_SESSION_CALLBACK(session, callback_time_uS)(ISOTP_SESSION_CONTEXT(session)) < session->tx_next_due_uS) {
+        return 0;
+    }
 
-        //  Assemble CAN frame
-        frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] &= ~ISOTP_SPEC_FRAME_TYPE_MASK; // Clear the type bits
-        frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] |= (ISOTP_SPEC_FRAME_FLOW_CONTROL << ISOTP_SPEC_FRAME_TYPE_SHIFT) & ISOTP_SPEC_FRAME_TYPE_MASK;
+    //  Default decision: request configured block & separation
+    isotp_fc_policy_t policy;
+    policy.frame_payload = session->rx_frame_size - ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
+    policy.transmission_remaining = session->full_transmission_length - session->buffer_offset;
+    policy.rx_space_remaining = (session->rx_sink != NULL) ? SIZE_MAX : session->rx_len - session->buffer_offset;
+    policy.wait_count = session->fc_wait_count;
+    policy.sequence_errors = session->rx_sequence_errors;
+    policy.flag = ISOTP_SPEC_FC_FLAG_CONTINUE_TO_SEND;
+    policy.block_size = session->fc_requested_block_size;
+    policy.separation_uS = session->fc_requested_separation_uS;
+
+    //  Streaming sink: limit block to the frames the sink can currently accept, wait while full
+    if(session->rx_sink != NULL && session->rx_sink->free_space != NULL) {
+        policy.rx_space_remaining = session->rx_sink->free_space(session->rx_sink->context);
+
+        size_t sink_frames = (policy.frame_payload > 0) ? policy.rx_space_remaining / policy.frame_payload : 0;
+        if(sink_frames > ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK) {
+            sink_frames = ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK;
+        }
 
-        // Set the flow control flag bits (lower nibble of the same byte)
-        frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_IDX] &= ~ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_MASK; // Clear the flag bits
-        frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_IDX] |= fc_flag & ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_MASK;
+        if(sink_frames == 0) {
+            policy.flag = ISOTP_SPEC_FC_FLAG_WAIT;
+        }
+        else if(policy.block_size == ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_SEND_WITHOUT_FC || policy.block_size > sink_frames) {
+            policy.block_size = (uint8_t)sink_frames;
+        }
+    }
 
-        // Set the block size
-        uint8_t block_size_send = session->fc_allowed_frames_remaining;
+    //  Let the user adapt the decision
+    if(ISOTP_SESSION_CALLBACK(session, callback_fc_policy) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_fc_policy)(ISOTP_SESSION_CONTEXT(session), &policy); }
 
-        //  Less frames remain than block size
-        //  TODO: implement somehow
+    if(policy.flag == ISOTP_SPEC_FC_FLAG_WAIT) {
+        //  Without a clock, WAIT frames could not be paced: hold flow control instead (a policy is asked again on the next call)
+        if(ISOTP_SESSION_CALLBACK(session, callback_time_uS) == NULL) {
+            return 0;
+        }
 
-        //  Unlimited block size
-        if(session->fc_allowed_frames_remaining == UINT16_MAX) {
-            block_size_send = ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_SEND_WITHOUT_FC;
+        //  Too many WAITs (N_WFTmax), give up
+        if(session->fc_wait_count >= session->protocol_config.fc_wait_max) {
+            policy.flag = ISOTP_SPEC_FC_FLAG_OVERFLOW_ABORT;
         }
+    }
 
-        frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_IDX] = block_size_send & ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK;
+    //  Assemble CAN frame
+    frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] &= ~ISOTP_SPEC_FRAME_TYPE_MASK; // Clear the type bits
+    frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] |= (ISOTP_SPEC_FRAME_FLOW_CONTROL << ISOTP_SPEC_FRAME_TYPE_SHIFT) & ISOTP_SPEC_FRAME_TYPE_MASK;
 
-        //  Set the seperation time
-        frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_IDX] = seperation_time & ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_MASK;
+    // Set the flow control flag bits (lower nibble of the same byte)
+    frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_IDX] &= ~ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_MASK; // Clear the flag bits
+    frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_IDX] |= policy.flag & ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_MASK;
 
-        //  Set frame length
-        return_val = ISOTP_SPEC_FRAME_FLOWCONTROL_HEADER_END;
+    //  Set the block size & seperation time
+    frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_IDX] = policy.block_size & ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_MASK;
+    frame_data[ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_IDX] = isotp_spec_fc_separation_time_byte(policy.separation_uS) & ISOTP_SPEC_FRAME_FLOWCONTROL_SEPARATION_TIME_MASK;
 
-        //  Reset flow control counter
-        session->fc_allowed_frames_remaining = session->protocol_config.fc_default_request_size;
-        if(session->fc_allowed_frames_remaining == 0) {
-            session->fc_allowed_frames_remaining = UINT16_MAX;
-        }
+    //  Set frame length
+    return_val = ISOTP_SPEC_FRAME_FLOWCONTROL_HEADER_END;
+    ISOTP_STATS_INC(session, frames_tx[ISOTP_SPEC_FRAME_FLOW_CONTROL]);
+    ISOTP_TRACE_FC(session, ISOTP_TRACE_FC_TX, policy.flag, policy.block_size, policy.separation_uS);
+
+    switch(policy.flag) {
+        case ISOTP_SPEC_FC_FLAG_CONTINUE_TO_SEND:
+            //  Allow requested block (0 = all frames)
+            session->fc_allowed_frames_remaining = policy.block_size;
+            if(session->fc_allowed_frames_remaining == ISOTP_SPEC_FRAME_FLOWCONTROL_BLOCKSIZE_SEND_WITHOUT_FC) {
+                session->fc_allowed_frames_remaining = UINT16_MAX;
+            }
+
+            session->fc_wait_count = 0;
+            timer_arm(session, ISOTP_SESSION_TIMER_N_CR, 0);
+            break;
+        case ISOTP_SPEC_FC_FLAG_WAIT:
+            //  Flow control stays pending, retry after the wait interval
+            session->fc_wait_count++;
+            ISOTP_STATS_INC(session, fc_wait_tx);
+            if(ISOTP_SESSION_CALLBACK(session, callback_time_uS) != NULL) {
+                session->tx_next_due_uS = ISOTP_SESSION_CALLBACK(session, callback_time_uS)(ISOTP_SESSION_CONTEXT(session)) + session->protocol_config.fc_wait_interval_uS;
+            }
+
+            timer_arm(session, ISOTP_SESSION_TIMER_N_CR, session->protocol_config.fc_wait_interval_uS);
+            break;
+        case ISOTP_SPEC_FC_FLAG_OVERFLOW_ABORT:
+        default:
+            //  Reception abandoned
+            ISOTP_STATS_INC(session, fc_overflow_tx);
+            ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_FC_OVERFLOW, NULL, 0);
+            isotp_session_idle(session);
+            break;
     }
 
     //  Return
     return return_val;
 }
 
+//  Prefixes the address byte of a frame built behind it, pads it (if enabled) and runs the CAN TX callback
+static size_t tx_finalize_frame(isotp_session_t* session, uint8_t* frame_data, size_t frame_length, const size_t frame_size) {
+    //  No frame
+    if(frame_length == 0) {
+        return 0;
+    }
+
+    //  Address byte (extended & mixed addressing)
+    const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+    if(address_offset > 0) {
+        frame_data[ISOTP_SPEC_FRAME_ADDRESS_IDX] = session->protocol_config.tx_address;
+        frame_length += address_offset;
+    }
+
+    //  Padding (if enabled). CAN FD only pads up to the next data length step, and must past 8 bytes.
+    size_t padded_length = session->protocol_config.padding_enabled ? frame_size : frame_length;
+    if(session->protocol_config.frame_format == ISOTP_FORMAT_FD) {
+        if(frame_length > ISOTP_SPEC_FD_DLC_CLASSIC_MAX) {
+            padded_length = isotp_spec_fd_frame_length(frame_length);
+        }
+        else if(session->protocol_config.padding_enabled) {
+            padded_length = ISOTP_SPEC_FD_DLC_CLASSIC_MAX;
+        }
+
+        //  Never past the frame
+        if(padded_length > frame_size) {
+            padded_length = frame_size;
+        }
+    }
+
+    if(frame_length < padded_length) {
+        memset(frame_data + frame_length, session->protocol_config.padding_byte, padded_length - frame_length);
+
+        //  Update frame length
+        frame_length = padded_length;
+    }
+
+    //  Trace & CAN TX callback
+    ISOTP_TRACE(session, ISOTP_TRACE_FRAME_TX, frame_length, frame_data, frame_length);
+    if(ISOTP_SESSION_CALLBACK(session, callback_can_tx) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_can_tx)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
+
+    return frame_length;
+}
+
+//  Starts the oldest queued message once the session is idle. Returns true if a transmission was started.
+static bool tx_queue_start(isotp_session_t* session) {
+    if(session->state != ISOTP_SESSION_IDLE || session->tx_queue == NULL || session->tx_queue_head == session->tx_queue_tail) {
+        return false;
+    }
+
+    const isotp_tx_message_t* message = &session->tx_queue[session->tx_queue_tail & session->tx_queue_mask];
+    if(isotp_session_send_borrowed(session, message->data, message->length) == 0) {
+        return false;
+    }
+
+    session->tx_queue_active = true;
+    return true;
+}
+
+//  Time a direction in `state` next has a frame to send
+static uint64_t tx_due(const isotp_session_t* session, const isotp_session_state_t state, const uint16_t fc_allowed_frames_remaining, const uint64_t tx_next_due_uS) {
+    switch(state) {
+        case ISOTP_SESSION_TRANSMITTING:
+            //  Next frame, once separation time has passed
+            return tx_next_due_uS;
+        case ISOTP_SESSION_RECEIVING:
+            //  Flow control frame pending (LIN has no FC), after any FC WAIT interval
+            if(fc_allowed_frames_remaining == 0 && session->protocol_config.frame_format != ISOTP_FORMAT_LIN) {
+                return tx_next_due_uS;
+            }
+            return ISOTP_SESSION_DEADLINE_NONE;
+        case ISOTP_SESSION_IDLE:
+            //  Queued message starts on the next fetch
+            if(session->tx_queue != NULL && session->tx_queue_head != session->tx_queue_tail) {
+                return 0;
+            }
+            break;
+        case ISOTP_SESSION_RECEIVED:
+        case ISOTP_SESSION_TRANSMITTING_AWAITING_FC:
+            break;
+    }
+
+    //  Nothing to send
+    return ISOTP_SESSION_DEADLINE_NONE;
+}
+
+uint64_t isotp_session_next_tx_due(const isotp_session_t* session) {
+    //  Safety
+    if(session == NULL) {
+        return ISOTP_SESSION_DEADLINE_NONE;
+    }
+
+    uint64_t due = tx_due(session, session->state, session->fc_allowed_frames_remaining, session->tx_next_due_uS);
+
+    //  Full duplex: the parked direction may be due earlier
+    if(session->protocol_config.full_duplex) {
+        const isotp_session_direction_t* parked = &session->duplex_parked;
+        const uint64_t parked_due = tx_due(session, parked->state, parked->fc_allowed_frames_remaining, parked->tx_next_due_uS);
+        if(parked_due < due) {
+            due = parked_due;
+        }
+    }
+
+    return due;
+}
+
 size_t isotp_session_can_tx(isotp_session_t* session, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS) {
     //  Default to no separation
     if(requested_separation_uS != NULL) { *requested_separation_uS = 0; }
@@ -762,9 +1401,31 @@ size_t isotp_session_can_tx(isotp_session_t* session, uint8_t* frame_data, const
         return 0;
     }
 
+    //  Frames are built behind the address byte (extended & mixed addressing)
+    const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+    if(frame_size <= address_offset) {
+        return 0;
+    }
+
+    //  Full duplex: a flow control frame the reception is waiting on goes ahead of the transmission
+    size_t ret_frame_length = 0;
+    if(session->protocol_config.full_duplex) {
+        const bool previous = duplex_enter(session, true);
+        ret_frame_length = tx_recieving(session, frame_data + address_offset, frame_size - address_offset, requested_separation_uS);
+        ret_frame_length = tx_finalize_frame(session, frame_data, ret_frame_length, frame_size);
+        duplex_leave(session, previous);
+
+        if(ret_frame_length > 0) {
+            return ret_frame_length;
+        }
+    }
+
+    const bool previous = duplex_enter(session, false);
+
+    //  Next queued message, if the previous transmission has ended
+    tx_queue_start(session);
 
     //  Determine action based on session state
-    uint32_t ret_frame_length = 0;
     switch(session->state) {
         case ISOTP_SESSION_IDLE:
         case ISOTP_SESSION_RECEIVED:
@@ -774,29 +1435,80 @@ size_t isotp_session_can_tx(isotp_session_t* session, uint8_t* frame_data, const
             break;
         case ISOTP_SESSION_TRANSMITTING:
             //  Transmitting
-            ret_frame_length = tx_transmitting(session, frame_data, frame_size, requested_separation_uS);
+            ret_frame_length = tx_transmitting(session, frame_data + address_offset, frame_size - address_offset, requested_separation_uS);
             break;
         case ISOTP_SESSION_RECEIVING:
             //  Receiving
-            ret_frame_length = tx_recieving(session, frame_data, frame_size, requested_separation_uS);
+            ret_frame_length = tx_recieving(session, frame_data + address_offset, frame_size - address_offset, requested_separation_uS);
             break;
     }
 
-    //  Padding (if enabled)
-    if(session->protocol_config.padding_enabled && ret_frame_length > 0) {
-        for(size_t i = ret_frame_length; i < frame_size; i++) {
-            frame_data[i] = session->protocol_config.padding_byte;
+    //  Pad & report
+    ret_frame_length = tx_finalize_frame(session, frame_data, ret_frame_length, frame_size);
+    duplex_leave(session, previous);
+
+    return ret_frame_length;
+}
+
+size_t isotp_session_can_tx_batch(isotp_session_t* session, isotp_can_frame_t* frames, const size_t max_frames, const size_t frame_size, uint32_t* requested_separation_uS) {
+    //  Default to no separation
+    if(requested_separation_uS != NULL) { *requested_separation_uS = 0; }
+
+    //  Safety
+    if(session == NULL || frames == NULL || max_frames == 0) {
+        return 0;
+    }
+
+    //  Limit to frame container size
+    const size_t size = (frame_size > ISOTP_CAN_FRAME_MAX_SIZE) ? ISOTP_CAN_FRAME_MAX_SIZE : frame_size;
+    size_t frame_count = 0;
+
+    //  Frames are built behind the address byte (extended & mixed addressing)
+    const size_t address_offset = ISOTP_SESSION_ADDRESS_OFFSET(session);
+    if(size <= address_offset) {
+        return 0;
+    }
+
+    //  Receiving only ever needs a single flow control frame (full duplex: sent ahead of the transmission)
+    const bool previous_rx = duplex_enter(session, true);
+    if(session->state == ISOTP_SESSION_RECEIVING) {
+        size_t length = tx_recieving(session, frames[0].data + address_offset, size - address_offset, requested_separation_uS);
+        length = tx_finalize_frame(session, frames[0].data, length, size);
+        if(length > 0) {
+            frames[0].length = (uint8_t)length;
+            frame_count = 1;
         }
+    }
+    duplex_leave(session, previous_rx);
 
-        //  Update frame length
-        ret_frame_length = frame_size;
+    const bool previous = duplex_enter(session, false);
+
+    //  Next queued message, if the previous transmission has ended
+    tx_queue_start(session);
+
+    //  Produce frames back-to-back until the transmission has to wait (FC, separation time or done)
+    while(frame_count < max_frames && session->state == ISOTP_SESSION_TRANSMITTING) {
+        uint32_t separation_uS = 0;
+        size_t length = tx_transmitting(session, frames[frame_count].data + address_offset, size - address_offset, &separation_uS);
+        length = tx_finalize_frame(session, frames[frame_count].data, length, size);
+        if(length == 0) {
+            break;
+        }
+
+        frames[frame_count].length = (uint8_t)length;
+        frame_count++;
+
+        //  Separation required before the next frame
+        if(separation_uS > 0) {
+            if(requested_separation_uS != NULL) { *requested_separation_uS = separation_uS; }
+            break;
+        }
     }
 
-    //  CAN TX callback
-    if(session->callback_can_tx != NULL && ret_frame_length > 0) { session->callback_can_tx(session, frame_data, ret_frame_length); }
+    duplex_leave(session, previous);
 
-    //  No action taken
-    return ret_frame_length;
+    //  Return
+    return frame_count;
 }
 
 /*
@@ -804,20 +1516,65 @@ size_t isotp_session_can_tx(isotp_session_t* session, uint8_t* frame_data, const
     Helpers
 
 */
-void isotp_session_idle(isotp_session_t* session) {
-    //  Safety
-    if(session == NULL) {
-        return;
+//  Ends the transfer held by the live fields (the only one in half duplex)
+static void idle_direction(isotp_session_t* session) {
+    //  Note transmission being ended
+    bool was_transmitting = (session->state == ISOTP_SESSION_TRANSMITTING || session->state == ISOTP_SESSION_TRANSMITTING_AWAITING_FC);
+    bool tx_completed = was_transmitting && session->buffer_offset >= session->full_transmission_length;
+
+    //  Release the queue slot of a queued message that ended
+    const bool queued_ended = was_transmitting && session->tx_queue_active;
+    isotp_tx_message_t queued = { NULL, 0, NULL, NULL };
+    if(queued_ended) {
+        queued = session->tx_queue[session->tx_queue_tail & session->tx_queue_mask];
+        session->tx_queue_tail++;
+        session->tx_queue_active = false;
     }
 
     //  Reset session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_IDLE);
     session->state = ISOTP_SESSION_IDLE;
     session->fc_allowed_frames_remaining = 0;
     session->fc_requested_separation_uS = session->protocol_config.fc_default_separation_time;
     session->fc_requested_block_size = session->protocol_config.fc_default_request_size;
     session->buffer_offset = 0;
     session->full_transmission_length = 0;
+    session->rx_frame_size = 0;
+    session->tx_frame_size = 0;
+    session->tx_next_due_uS = 0;
+    session->fc_wait_count = 0;
     session->fc_idx_track_consecutive = session->protocol_config.consecutive_index_first;
+
+    //  Release borrowed memory (owned by the transmission)
+    if(!session->duplex_rx_loaded) {
+        session->tx_fragments = NULL;
+        session->tx_fragment_count = 0;
+        session->tx_fragment_idx = 0;
+        session->tx_fragment_offset = 0;
+    }
+
+    //  Disarm timers
+    timer_arm(session, ISOTP_SESSION_TIMER_NONE, 0);
+
+    //  Callbacks (last, so a new transmission can be started from them)
+    if(queued_ended && queued.callback_complete != NULL) { queued.callback_complete(session, &queued, tx_completed); }
+    if(was_transmitting && ISOTP_SESSION_CALLBACK(session, callback_transmission_tx) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_transmission_tx)(ISOTP_SESSION_CONTEXT(session), tx_completed); }
+}
+
+void isotp_session_idle(isotp_session_t* session) {
+    //  Safety
+    if(session == NULL) {
+        return;
+    }
+
+    //  Full duplex: the application idling the session ends the reception as well, callbacks only end their own direction
+    if(session->protocol_config.full_duplex && session->duplex_depth == 0) {
+        const bool previous = duplex_enter(session, true);
+        idle_direction(session);
+        duplex_leave(session, previous);
+    }
+
+    idle_direction(session);
 }
 
 size_t isotp_session_send(isotp_session_t* session, const uint8_t* data, const size_t data_length) {
@@ -826,6 +1583,9 @@ size_t isotp_session_send(isotp_session_t* session, const uint8_t* data, const s
         return 0;
     }
 
+    //  Transmission state (full duplex)
+    const bool previous = duplex_enter(session, false);
+
     //  Reset session state
     isotp_session_idle(session);
 
@@ -846,12 +1606,103 @@ size_t isotp_session_send(isotp_session_t* session, const uint8_t* data, const s
     session->full_transmission_length = copy_len;
 
     //  Update session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING);
     session->state = ISOTP_SESSION_TRANSMITTING;
+    timer_arm(session, ISOTP_SESSION_TIMER_N_AS, 0);
+    duplex_leave(session, previous);
 
     //  Return
     return copy_len;
 }
 
+uint64_t isotp_session_tick(isotp_session_t* session, const uint64_t now_uS) {
+    //  Safety
+    if(session == NULL) {
+        return ISOTP_SESSION_DEADLINE_NONE;
+    }
+
+    //  Expire
+    if(session->deadline_uS != ISOTP_SESSION_DEADLINE_NONE && now_uS >= session->deadline_uS) {
+        //  Full duplex: N_Cr belongs to the reception, N_As & N_Bs to the transmission
+        const isotp_session_timer_t timer = session->deadline_timer;
+        const bool previous = duplex_enter(session, timer == ISOTP_SESSION_TIMER_N_CR);
+        timer_arm(session, ISOTP_SESSION_TIMER_NONE, 0);
+        ISOTP_STATS_INC(session, timeouts);
+        ISOTP_TRACE_ERROR(session, ISOTP_TRACE_ERROR_TIMEOUT, ((const uint8_t[]){ (uint8_t)timer }), 1);
+
+        if(ISOTP_SESSION_CALLBACK(session, callback_error_timeout) != NULL) { ISOTP_SESSION_CALLBACK(session, callback_error_timeout)(ISOTP_SESSION_CONTEXT(session), timer); }
+        else { isotp_session_idle(session); }
+
+        duplex_leave(session, previous);
+    }
+
+    //  Next deadline (callback may have re-armed)
+    return session->deadline_uS;
+}
+
+size_t isotp_session_send_fragments(isotp_session_t* session, const isotp_tx_fragment_t* fragments, const size_t fragment_count) {
+    //  Safety
+    if(session == NULL || fragments == NULL || fragment_count == 0) {
+        return 0;
+    }
+
+    //  Total message length
+    size_t total_length = 0;
+    for(size_t i = 0; i < fragment_count; i++) {
+        if(fragments[i].data == NULL && fragments[i].length > 0) {
+            return 0;
+        }
+
+        total_length += fragments[i].length;
+    }
+
+    if(total_length == 0) {
+        return 0;
+    }
+
+    //  Transmission state (full duplex)
+    const bool previous = duplex_enter(session, false);
+
+    //  Reset session state
+    isotp_session_idle(session);
+
+    //  Borrow fragments
+    session->tx_fragments = fragments;
+    session->tx_fragment_count = fragment_count;
+
+    //  Set transmit length
+    session->full_transmission_length = total_length;
+
+    //  Update session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING);
+    session->state = ISOTP_SESSION_TRANSMITTING;
+    timer_arm(session, ISOTP_SESSION_TIMER_N_AS, 0);
+    duplex_leave(session, previous);
+
+    //  Return
+    return total_length;
+}
+
+size_t isotp_session_send_borrowed(isotp_session_t* session, const uint8_t* data, const size_t data_length) {
+    //  Safety
+    if(session == NULL || data == NULL || data_length == 0) {
+        return 0;
+    }
+
+    //  Reset session state before reusing borrowed fragment storage
+    const bool previous = duplex_enter(session, false);
+    isotp_session_idle(session);
+
+    //  Borrow as single fragment
+    session->tx_fragment_borrowed.data = data;
+    session->tx_fragment_borrowed.length = data_length;
+
+    const size_t ret = isotp_session_send_fragments(session, &session->tx_fragment_borrowed, 1);
+    duplex_leave(session, previous);
+
+    return ret;
+}
+
 void isotp_session_init(isotp_session_t* session, const isotp_format_t frame_format, void* tx_buffer, size_t tx_len, void* rx_buffer, size_t rx_len) {
     //  Safety
     if(session == NULL) {
@@ -859,27 +1710,70 @@ void isotp_session_init(isotp_session_t* session, const isotp_format_t frame_for
     }
 
     //  Default protocol configuration
+    session->protocol_config.addressing_mode = ISOTP_ADDRESSING_NORMAL;
+    session->protocol_config.tx_address = 0;
+    session->protocol_config.rx_address = 0;
     session->protocol_config.padding_enabled = true;
     session->protocol_config.padding_byte = 0xFF;
     session->protocol_config.fd_header_force = false;
+    session->protocol_config.fd_tx_dl_planned = false;
     session->protocol_config.consecutive_index_first = ISOTP_SPEC_FRAME_CONSECUTIVE_INDEXING_START;
     session->protocol_config.consecutive_index_start = ISOTP_SPEC_FRAME_CONSECUTIVE_INDEXING_MIN;
     session->protocol_config.consecutive_index_end = ISOTP_SPEC_FRAME_CONSECUTIVE_INDEXING_MAX;
     session->protocol_config.fc_default_request_size = 0;   //  request all frames by default
     session->protocol_config.fc_default_separation_time = 0;    //  no delay by default
+    session->protocol_config.fc_wait_max = 10;
+    session->protocol_config.fc_wait_interval_uS = 100000;     //  well inside the partner's N_Bs
     session->protocol_config.frame_format = frame_format;
+    session->protocol_config.timeout_n_as_uS = ISOTP_SPEC_TIMEOUT_N_AS_DEFAULT_uS;
+    session->protocol_config.timeout_n_bs_uS = ISOTP_SPEC_TIMEOUT_N_BS_DEFAULT_uS;
+    session->protocol_config.timeout_n_cr_uS = ISOTP_SPEC_TIMEOUT_N_CR_DEFAULT_uS;
 
     //  Load buffers
     session->tx_buffer = tx_buffer;
     session->tx_len = tx_len;
     session->rx_buffer = rx_buffer;
     session->rx_len = rx_len;
+    session->rx_sink = NULL;
+    session->rx_slots = NULL;
+    session->rx_slot_count = 0;
+    session->rx_slot_idx = 0;
+    session->rx_pool = NULL;
+    session->rx_pool_block = NULL;
+    session->rx_pool_assign = NULL;
+    session->rx_pool_release = NULL;
+
+    //  Half duplex, with an idle parked reception should full duplex be enabled
+    session->protocol_config.full_duplex = false;
+    session->duplex_rx_loaded = false;
+    session->duplex_depth = 0;
+    session->duplex_deadline_uS[0] = ISOTP_SESSION_DEADLINE_NONE;
+    session->duplex_deadline_uS[1] = ISOTP_SESSION_DEADLINE_NONE;
+    session->duplex_deadline_timer[0] = ISOTP_SESSION_TIMER_NONE;
+    session->duplex_deadline_timer[1] = ISOTP_SESSION_TIMER_NONE;
+
+    //  No transmit queue
+    session->tx_queue = NULL;
+    session->tx_queue_mask = 0;
+    session->tx_queue_head = 0;
+    session->tx_queue_tail = 0;
+    session->tx_queue_active = false;
 
     //  Clear callbacks
+    session->user_context = NULL;
+#ifdef ISOTP_SESSION_SHARED_OPS
+    session->ops = &session_ops_none;
+#else
+    session->ops = NULL;
     session->callback_can_rx = NULL;
     session->callback_can_tx = NULL;
     session->callback_transmission_rx = NULL;
     session->callback_mem_assign = NULL;
+    session->callback_transmission_tx = NULL;
+    session->callback_time_uS = NULL;
+    session->callback_error_timeout = NULL;
+    session->callback_fc_policy = NULL;
+    session->callback_error_rx_busy = NULL;
     session->callback_peek_first_frame = NULL;
     session->callback_peek_consecutive_frame = NULL;
     session->callback_peek_flow_control_frame = NULL;
@@ -888,9 +1782,61 @@ void isotp_session_init(isotp_session_t* session, const isotp_format_t frame_for
     session->callback_error_partner_aborted_transfer = NULL;
     session->callback_error_unexpected_frame_type = NULL;
     session->callback_error_consecutive_out_of_order = NULL;
+#endif
+
+    //  Statistics
+    session->rx_sequence_errors = 0;
+    isotp_stats_reset(session);
+
+    //  Timers
+    session->timer_heap = NULL;
+    session->timer_heap_idx = 0;
+
+    //  Tracing
+#ifdef ISOTP_ENABLE_TRACE
+    session->trace = NULL;
+    session->trace_id = 0;
+#endif
 
     //  Reset session state
+    ISOTP_TRACE_STATE(session, ISOTP_SESSION_IDLE);
+    session->state = ISOTP_SESSION_IDLE;
     isotp_session_idle(session);
+
+    //  Parked reception starts out idle as well, should full duplex be enabled
+    duplex_save(session, &session->duplex_parked);
+}
+
+void isotp_session_use_ops(isotp_session_t* session, const isotp_session_ops_t* ops, void* user_context) {
+    //  Safety
+    if(session == NULL) {
+        return;
+    }
+
+#ifdef ISOTP_SESSION_SHARED_OPS
+    //  No callback fields to fall back to
+    if(ops == NULL) {
+        ops = &session_ops_none;
+    }
+#endif
+
+    session->ops = ops;
+    session->user_context = user_context;
+}
+
+//  Whether the reception may change buffers: idle, or inside `callback_mem_assign` before any data is stored
+static bool rx_buffer_switchable(const isotp_session_t* session) {
+    isotp_session_state_t state = session->state;
+    size_t buffer_offset = session->buffer_offset;
+
+    //  Full duplex: the reception may be parked
+    if(session->protocol_config.full_duplex && !session->duplex_rx_loaded) {
+        state = session->duplex_parked.state;
+        buffer_offset = session->duplex_parked.buffer_offset;
+    }
+
+    //  Recieving state callback only
+    return state == ISOTP_SESSION_IDLE || (state == ISOTP_SESSION_RECEIVING && buffer_offset == 0);
 }
 
 bool isotp_session_use_rx_buffer(isotp_session_t* session, void* rx_buffer, size_t rx_len) {
@@ -900,12 +1846,7 @@ bool isotp_session_use_rx_buffer(isotp_session_t* session, void* rx_buffer, size
     }
 
     //  Check state
-    if(session->state != ISOTP_SESSION_IDLE && session->state != ISOTP_SESSION_RECEIVING) {
-        return false;
-    }
-
-    //  Recieving state callback only
-    if(session->state == ISOTP_SESSION_RECEIVING && session->buffer_offset != 0) {
+    if(!rx_buffer_switchable(session)) {
         return false;
     }
 
@@ -915,4 +1856,146 @@ bool isotp_session_use_rx_buffer(isotp_session_t* session, void* rx_buffer, size
 
     //  Success
     return true;
-}
\ No newline at end of file
+}
+
+bool isotp_session_use_rx_sink(isotp_session_t* session, const isotp_rx_sink_t* rx_sink) {
+    //  Safety
+    if(session == NULL) {
+        return false;
+    }
+
+    //  Sinks must be able to accept data
+    if(rx_sink != NULL && rx_sink->write == NULL) {
+        return false;
+    }
+
+    //  Check state
+    if(!rx_buffer_switchable(session)) {
+        return false;
+    }
+
+    //  Update sink
+    session->rx_sink = rx_sink;
+
+    //  Success
+    return true;
+}
+
+bool isotp_session_use_rx_slots(isotp_session_t* session, isotp_rx_slot_t* slots, const size_t slot_count) {
+    //  Safety
+    if(session == NULL || (slots != NULL && slot_count == 0)) {
+        return false;
+    }
+
+    //  Pool blocks and slots do not mix
+    if(slots != NULL && session->rx_pool != NULL) {
+        return false;
+    }
+
+    //  Every slot needs memory
+    for(size_t i = 0; slots != NULL && i < slot_count; i++) {
+        if(slots[i].buffer == NULL || slots[i].size == 0) {
+            return false;
+        }
+    }
+
+    //  Check state
+    if(!rx_buffer_switchable(session)) {
+        return false;
+    }
+
+    //  Remove slots, the current buffer stays in use
+    if(slots == NULL) {
+        session->rx_slots = NULL;
+        session->rx_slot_count = 0;
+        session->rx_slot_idx = 0;
+        return true;
+    }
+
+    //  All slots start out free
+    for(size_t i = 0; i < slot_count; i++) {
+        slots[i].length = 0;
+        __atomic_store_n(&slots[i].held, false, __ATOMIC_RELAXED);
+    }
+
+    //  Update slots, recieving into the first one
+    session->rx_slots = slots;
+    session->rx_slot_count = slot_count;
+    session->rx_slot_idx = 0;
+    session->rx_buffer = slots[0].buffer;
+    session->rx_len = slots[0].size;
+
+    //  Success
+    return true;
+}
+
+bool isotp_session_release_rx(isotp_session_t* session, const void* buffer) {
+    //  Safety
+    if(session == NULL || buffer == NULL) {
+        return false;
+    }
+
+    //  Pool blocks go straight back to the pool
+    if(session->rx_pool != NULL && session->rx_pool_release != NULL) {
+        return session->rx_pool_release(session->rx_pool, (void*)buffer);
+    }
+
+    for(size_t i = 0; i < session->rx_slot_count; i++) {
+        isotp_rx_slot_t* slot = &session->rx_slots[i];
+        if(slot->buffer != buffer) {
+            continue;
+        }
+
+        //  Only held slots, the session picks released ones up when the next message starts
+        bool held = true;
+        return __atomic_compare_exchange_n(&slot->held, &held, false, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    }
+
+    return false;
+}
+
+bool isotp_session_use_tx_queue(isotp_session_t* session, isotp_tx_message_t* messages, const size_t capacity) {
+    //  Safety (capacity must be a power of two so positions can be masked)
+    if(session == NULL || (messages != NULL && (capacity == 0 || (capacity & (capacity - 1)) != 0))) {
+        return false;
+    }
+
+    //  Queued messages would be lost
+    if(session->tx_queue_head != session->tx_queue_tail) {
+        return false;
+    }
+
+    session->tx_queue = messages;
+    session->tx_queue_mask = (messages != NULL) ? capacity - 1 : 0;
+    session->tx_queue_head = 0;
+    session->tx_queue_tail = 0;
+    session->tx_queue_active = false;
+
+    return true;
+}
+
+bool isotp_session_queue_send(isotp_session_t* session, const isotp_tx_message_t* message) {
+    //  Safety
+    if(session == NULL || session->tx_queue == NULL || message == NULL || message->data == NULL || message->length == 0) {
+        return false;
+    }
+
+    //  Queue full
+    if(session->tx_queue_head - session->tx_queue_tail > session->tx_queue_mask) {
+        return false;
+    }
+
+    session->tx_queue[session->tx_queue_head & session->tx_queue_mask] = *message;
+    session->tx_queue_head++;
+
+    return true;
+}
+
+size_t isotp_session_tx_queue_count(const isotp_session_t* session) {
+    //  Safety
+    if(session == NULL) {
+        return 0;
+    }
+
+    return session->tx_queue_head - session->tx_queue_tail;
+}
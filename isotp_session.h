@@ -39,15 +39,51 @@ typedef enum {
 	//	TODO: FlexRay?
 } isotp_format_t;
 
+//	ISO-TP addressing formats
+typedef enum {
+	ISOTP_ADDRESSING_NORMAL = 0,			//	Protocol control information starts at byte 0
+	ISOTP_ADDRESSING_EXTENDED = 1,			//	Byte 0 is the target address (N_TA)
+	ISOTP_ADDRESSING_MIXED = 2,				//	Byte 0 is the address extension (N_AE)
+} isotp_addressing_t;
+
+//	Bytes preceding the protocol control information of every frame
+#define ISOTP_SESSION_ADDRESS_OFFSET(session) (((session)->protocol_config.addressing_mode != ISOTP_ADDRESSING_NORMAL) ? ISOTP_SPEC_FRAME_ADDRESS_LEN : 0)
+
+//	ISO-TP network layer timers
+typedef enum {
+	ISOTP_SESSION_TIMER_NONE = 0,
+	ISOTP_SESSION_TIMER_N_AS = 1,			//	Sender: next frame of a transmission not fetched in time
+	ISOTP_SESSION_TIMER_N_BS = 2,			//	Sender: flow control not recieved in time
+	ISOTP_SESSION_TIMER_N_CR = 3,			//	Reciever: consecutive frame not recieved in time
+} isotp_session_timer_t;
+
+//	Deadline value meaning no timer is armed
+#define ISOTP_SESSION_DEADLINE_NONE UINT64_MAX
+
+//	Timer heap a session may be attached to (see isotp_timer.h)
+struct isotp_timer_heap_s;
+
+//	Trace ring a session may record to (see isotp_trace.h)
+struct isotp_trace_ring_s;
+
 typedef struct {
 	//	Frame Format
 	isotp_format_t frame_format;			//	ISO-TP frame frame_format
 
+	//	Addressing
+	isotp_addressing_t addressing_mode;		//	Normal, extended or mixed addressing (extended & mixed prefix every frame with an address byte)
+	uint8_t tx_address;						//	Address byte prefixed to transmitted frames (partner's N_TA, or N_AE)
+	uint8_t rx_address;						//	Address byte recieved frames must carry, frames for other addresses are ignored (own N_TA, or N_AE)
+
+	//	Duplex
+	bool full_duplex;						//	Transmission and reception proceed independently: flow control frames belong to the transmission, all other frames to the reception (only change while idle)
+
 	//	FD
 	bool fd_header_force;					//	Forces CAN FD headers even when data is small enough to use the non-FD frames
+	bool fd_tx_dl_planned;					//	Picks the frame size of each message with `isotp_spec_fd_plan_frame_size` (up to the frame size passed to `isotp_session_can_tx`) to cut bytes on the wire
 
 	//	Padding
-	bool padding_enabled;					//  Flag indicating if padding should be used
+	bool padding_enabled;					//  Flag indicating if padding should be used (CAN FD: frames up to 8 bytes only, longer frames are always padded to the next data length step)
 	uint8_t padding_byte;					//  Byte to use for padding
 
 	uint8_t consecutive_index_first;		//  Expected start index
@@ -56,12 +92,189 @@ typedef struct {
 
 	uint32_t fc_default_separation_time;	//  Valid uS seperation time for flow control frames (0 = no seperation, 100-900 uS or 1000-127000 uS)
 	size_t fc_default_request_size;			//  Number of frames to request in a flow control if not overridden (0 = all)
+
+	uint8_t fc_wait_max;					//  N_WFTmax: Max consecutive FC WAIT frames before reception is aborted with FC overflow
+	uint32_t fc_wait_interval_uS;			//  Interval between FC WAIT frames (requires `callback_time_uS`)
+
+	//	Timeouts (only enforced when `callback_time_uS` is set)
+	uint32_t timeout_n_as_uS;				//  N_As: Max time between transmission frames being fetched with `isotp_session_can_tx`, excluding separation time (0 = disabled)
+	uint32_t timeout_n_bs_uS;				//  N_Bs: Max time awaiting a flow control frame (0 = disabled)
+	uint32_t timeout_n_cr_uS;				//  N_Cr: Max time awaiting the next consecutive frame (0 = disabled)
 } isotp_session_protocol_config_t;
 
-// ISOTP session
+//	Largest CAN frame data length (CAN FD)
+#define ISOTP_CAN_FRAME_MAX_SIZE 64
+
+//	CAN frame container used by the batch APIs
+typedef struct {
+	uint32_t identifier;					//  Arbitration ID (not used by sessions, available to routers & drivers)
+	uint8_t length;							//  Frame data length
+	uint8_t data[ISOTP_CAN_FRAME_MAX_SIZE];	//  Frame data
+} isotp_can_frame_t;
+
+//	Borrowed transmit fragment, see `isotp_session_send_fragments`
+typedef struct {
+	const uint8_t* data;					//  Fragment data (must remain valid until `callback_transmission_tx`)
+	size_t length;							//  Fragment length
+} isotp_tx_fragment_t;
+
+//	Queued transmit message, see `isotp_session_use_tx_queue`
+typedef struct isotp_tx_message_s {
+	const uint8_t* data;					//  Message data, borrowed until `callback_complete` runs (must remain valid and unmodified)
+	size_t length;							//  Message length
+
+	/**
+	 * @brief (optional) Callback run with the session as context when this message ends, either fully sent (`completed`) or abandoned. `message` is a copy, its queue slot is already free.
+	 * 
+	 */
+	void (*callback_complete) (void* context, const struct isotp_tx_message_s* message, const bool completed);
+
+	void* context;							//  (Optional) User data for `callback_complete`, read through `message`
+} isotp_tx_message_t;
+
+//	Flow control decision passed to `callback_fc_policy`
+typedef struct {
+	//	Inputs
+	size_t rx_space_remaining;				//  Free bytes in the RX buffer or sink (SIZE_MAX = unknown/unlimited)
+	size_t transmission_remaining;			//  Bytes of the current message not yet recieved
+	size_t frame_payload;					//  Payload bytes per consecutive frame
+	uint8_t wait_count;						//  FC WAIT frames already sent in a row for this block
+	size_t sequence_errors;					//  Out of order consecutive frames seen since init (indicates dropped frames)
+
+	//	Outputs (pre-filled with the default decision)
+	isotp_flow_control_flags_t flag;		//  Continue to send, wait or overflow/abort
+	uint8_t block_size;						//  Frames to request (0 = all frames)
+	uint32_t separation_uS;					//  Separation time to request (0 = none, 100-900 uS or 1000-127000 uS)
+} isotp_fc_policy_t;
+
+//	Streaming receive sink, see `isotp_session_use_rx_sink`
+typedef struct {
+	/**
+	 * @brief (required) Accepts received payload bytes of the current message, starting at `offset` within the message. Returns the number of bytes accepted, anything less than `length` aborts the transfer through `callback_error_transmission_too_large`.
+	 * 
+	 */
+	size_t (*write)(void* context, const uint8_t* data, const size_t length, const size_t offset);
+
+	/**
+	 * @brief (optional) Returns how many bytes the sink can accept right now. Flow control block sizes are limited to fit, and flow control is held while the sink is full. NULL = unlimited.
+	 * 
+	 */
+	size_t (*free_space)(void* context);
+
+	void* context;							//  Passed to `write` and `free_space`
+} isotp_rx_sink_t;
+
+//	Receive slot, see `isotp_session_use_rx_slots`
+typedef struct {
+	void* buffer;							//  Slot memory
+	size_t size;							//  Slot capacity
+	size_t length;							//  (Live) Length of the message held (valid while `held`)
+	bool held;								//  (Live) Owned by the application until `isotp_session_release_rx`
+} isotp_rx_slot_t;
+
+//	Counter type of the optional session statistics (define ISOTP_STATS_COUNTER_TYPE as uint64_t for long running gateways)
+#ifndef ISOTP_STATS_COUNTER_TYPE
+#define ISOTP_STATS_COUNTER_TYPE uint32_t
+#endif
+
+typedef ISOTP_STATS_COUNTER_TYPE isotp_stat_t;
+
+//	Session statistics, only maintained when built with ISOTP_ENABLE_STATS (see isotp_stats.h)
+typedef struct {
+	isotp_stat_t frames_rx[4];					//  Frames recieved, indexed by isotp_spec_frame_type_t
+	isotp_stat_t frames_rx_invalid;				//  Frames recieved with an unknown frame type
+	isotp_stat_t frames_tx[4];					//  Frames transmitted, indexed by isotp_spec_frame_type_t
+	isotp_stat_t bytes_rx;						//  Payload bytes recieved
+	isotp_stat_t bytes_tx;						//  Payload bytes transmitted
+	isotp_stat_t transfers_rx;					//  Messages fully recieved
+	isotp_stat_t transfers_tx;					//  Messages fully transmitted
+	isotp_stat_t fc_wait_rx;					//  FC WAIT frames recieved
+	isotp_stat_t fc_wait_tx;					//  FC WAIT frames transmitted
+	isotp_stat_t fc_overflow_rx;				//  FC overflow/abort frames recieved (partner aborted)
+	isotp_stat_t fc_overflow_tx;				//  FC overflow/abort frames transmitted (N_WFTmax reached or policy abort)
+	isotp_stat_t out_of_order;					//  Receptions aborted by an out of order consecutive frame
+	isotp_stat_t too_large;						//  Receptions rejected as too large for the RX buffer or sink
+	isotp_stat_t rx_busy;						//  New messages dropped while the application still held the RX buffer (or every slot)
+	isotp_stat_t timeouts;						//  N_As/N_Bs/N_Cr timer expiries
+} isotp_session_stats_t;
+
+//	Transfer state of one direction of a full duplex session, see `protocol_config.full_duplex`
+typedef struct {
+	isotp_session_state_t state;
+	uint16_t fc_allowed_frames_remaining;
+	uint8_t fc_idx_track_consecutive;
+	uint8_t fc_requested_block_size;
+	uint32_t fc_requested_separation_uS;
+	size_t full_transmission_length;
+	size_t rx_frame_size;
+	size_t tx_frame_size;
+	size_t buffer_offset;
+	uint64_t tx_next_due_uS;
+	uint8_t fc_wait_count;
+} isotp_session_direction_t;
+
+//	Shared callback table, see `isotp_session_use_ops`. Every field behaves as the session field of the same name.
+//	One const table may serve any number of sessions, each telling its callbacks apart by `user_context`.
 typedef struct {
+	void (*callback_transmission_rx)(void* context);
+	void (*callback_error_invalid_frame) (void* context, const isotp_spec_frame_type_t rx_frame_type, const uint8_t* msg_data, const size_t msg_length);
+	void (*callback_error_partner_aborted_transfer) (void* context, const uint8_t* msg_data, const size_t msg_length);
+	void (*callback_error_transmission_too_large) (void* context, const uint8_t* data, const size_t length, const size_t requested_size);
+	void (*callback_error_consecutive_out_of_order) (void* context, const uint8_t* data, const size_t length, const uint8_t expected_index, const uint8_t recieved_index);
+	void (*callback_error_unexpected_frame_type) (void* context, const uint8_t* msg_data, const size_t msg_length);
+	void (*callback_peek_first_frame) (void* context, const uint8_t* data, const size_t length);
+	void (*callback_peek_consecutive_frame) (void* context, const uint8_t* data, const size_t length, const size_t start_idx);
+	void (*callback_peek_flow_control_frame) (void* context);
+	void (*callback_can_rx)(void* context, const uint8_t* msg_data, const size_t msg_length);
+	void (*callback_can_tx)(void* context, const uint8_t* msg_data, const size_t msg_length);
+	void (*callback_mem_assign) (void* context, const size_t indicated_length);
+	void (*callback_transmission_tx) (void* context, const bool completed);
+	uint64_t (*callback_time_uS) (void* context);
+	void (*callback_error_timeout) (void* context, const isotp_session_timer_t timer);
+	void (*callback_fc_policy) (void* context, isotp_fc_policy_t* policy);
+	void (*callback_error_rx_busy) (void* context, const uint8_t* msg_data, const size_t msg_length);
+} isotp_session_ops_t;
+
+//	Callback of a session: from its `ops` table when set, otherwise its own field. Built with ISOTP_SESSION_SHARED_OPS
+//	sessions have no callback fields of their own and `ops` is required.
+#ifdef ISOTP_SESSION_SHARED_OPS
+#define ISOTP_SESSION_CALLBACK(session, callback) ((session)->ops->callback)
+#else
+#define ISOTP_SESSION_CALLBACK(session, callback) (((session)->ops != NULL) ? (session)->ops->callback : (session)->callback)
+#endif
+
+//	Context passed to a session's callbacks: its `user_context`, or the session itself when none is set
+#define ISOTP_SESSION_CONTEXT(session) (((session)->user_context != NULL) ? (session)->user_context : (void*)(session))
+
+//  Session alignment, so the hot state at the front of a session shares one cache line (heap allocated sessions need `aligned_alloc`)
+#ifndef ISOTP_SESSION_CACHE_LINE
+#define ISOTP_SESSION_CACHE_LINE 64
+#endif
+
+// ISOTP session
+typedef struct __attribute__((aligned(ISOTP_SESSION_CACHE_LINE))) {
+	//  Hot state, kept together at the front so the per-frame path touches a single cache line
+	isotp_session_state_t state;				//  (Live) Current session state
+
+	//  Bidirectional parameters
+	uint16_t fc_allowed_frames_remaining;		//  (Live) Counter of frames that can be sent/recieved before flow control reqd (0 = FC needed, UINT16_MAX = FC not required)
+	uint8_t fc_idx_track_consecutive;			//	(Live) Index of last consecutive frame index sent/recieved
+	
+	uint8_t fc_requested_block_size;			//  (Config) Block size currently requested (0 = All frames)
+	uint32_t fc_requested_separation_uS;		//  (Config) Separation time currently requested (0 = No separation time)
+
+	size_t full_transmission_length;			//  (Live) Reported length of the transmission being sent/recieved
+	size_t buffer_offset;                		//  (Live) How many bytes have been sent/recieved from the current buffer
+	size_t rx_frame_size;						//  (Live) Frame length of the received first frame, which consecutive frames match
+	size_t tx_frame_size;						//  (Live) Frame size planned for the message being sent, excluding the address byte (0 = frame size passed to `isotp_session_can_tx`)
+
+	//	Callbacks
+	const isotp_session_ops_t* ops;				//  (Config) Shared callback table used instead of the fields below (NULL = per-session callbacks, see `isotp_session_use_ops`)
+	void* user_context;							//  (Config) Context passed to every callback (NULL = the session itself)
+
+#ifndef ISOTP_SESSION_SHARED_OPS
 	/**
-	 * @brief (required) Callback run when a full transmission is recieved. The data can be accessed from inside the session.
+	 * @brief (required) Callback run when a full transmission is recieved. The data can be accessed from inside the session. With receive slots (see `isotp_session_use_rx_slots`) or a pool (see `isotp_pool_attach`), `rx_buffer` is the message's slot or block, held until `isotp_session_release_rx`.
 	 * 
 	 */
 	void (*callback_transmission_rx)(void* context);
@@ -127,11 +340,42 @@ typedef struct {
 	void (*callback_can_tx)(void* context, const uint8_t* msg_data, const size_t msg_length);
 
 	/**
-	 * @brief (optional) If desired, the user can allocate memory with `isotp_session_use_rx_buffer` at the start of each new message inside this callback
+	 * @brief (optional) If desired, the user can allocate memory with `isotp_session_use_rx_buffer` (or select a sink with `isotp_session_use_rx_sink`) at the start of each new message inside this callback
 	 * 
 	 */
 	void (*callback_mem_assign) (void* context, const size_t indicated_length);
 
+	/**
+	 * @brief (optional) Callback run when a transmission ends, either fully sent (`completed`) or abandoned. Memory borrowed with `isotp_session_send_borrowed`/`isotp_session_send_fragments` may be reused from this point. A new transmission may be started from inside this callback when `completed` is set.
+	 * 
+	 */
+	void (*callback_transmission_tx) (void* context, const bool completed);
+
+	/**
+	 * @brief (optional) Monotonic clock in uS. Enables the N_As/N_Bs/N_Cr timeouts configured in `protocol_config` and internal separation time pacing (see `isotp_session_next_tx_due`).
+	 * 
+	 */
+	uint64_t (*callback_time_uS) (void* context);
+
+	/**
+	 * @brief (optional) Callback run from `isotp_session_tick` when a timer expires. Typically just cancel with `isotp_session_idle`, which is the default if NULL.
+	 * 
+	 */
+	void (*callback_error_timeout) (void* context, const isotp_session_timer_t timer);
+
+	/**
+	 * @brief (optional) Callback run before each flow control frame is sent. Adjust `policy` outputs to adapt block size and separation time to load, or request FC WAIT under backpressure. More than `protocol_config.fc_wait_max` WAITs in a row aborts reception. Without `callback_time_uS`, WAIT frames are not sent: flow control is held and the policy asked again by the next `isotp_session_can_tx`.
+	 * 
+	 */
+	void (*callback_fc_policy) (void* context, isotp_fc_policy_t* policy);
+
+	/**
+	 * @brief (optional) Callback run when a new message is dropped because the application still holds the RX buffer (session left in `ISOTP_SESSION_RECEIVED`) or every receive slot. Idle the session or release a slot with `isotp_session_release_rx` to receive again.
+	 * 
+	 */
+	void (*callback_error_rx_busy) (void* context, const uint8_t* msg_data, const size_t msg_length);
+#endif
+
 	//	ISO-TP Protocol Configuration
 	isotp_session_protocol_config_t protocol_config;
 
@@ -140,23 +384,65 @@ typedef struct {
 	size_t tx_len;
 	void* rx_buffer;
 	size_t rx_len;
+	const isotp_rx_sink_t* rx_sink;				//  (Config) Streaming receive sink (NULL = receive into rx_buffer)
+
+	//	Receive slots
+	isotp_rx_slot_t* rx_slots;					//  (Config) User provided slots taking turns as `rx_buffer` (NULL = single buffer, see `isotp_session_use_rx_slots`)
+	size_t rx_slot_count;						//  (Config) Number of slots
+	size_t rx_slot_idx;							//  (Live) Slot recieving, or about to
+
+	//	Receive pool
+	struct isotp_pool_s* rx_pool;				//  (Config) Pool RX buffers are drawn from (NULL = none, see `isotp_pool_attach`)
+	void* rx_pool_block;						//  (Live) Pool block of the reception in progress, not yet handed to the application
+	void (*rx_pool_assign) (void* session, const size_t indicated_length);	//  (Config) Selects the pool block of a starting message, installed by `isotp_pool_attach`
+	bool (*rx_pool_release) (struct isotp_pool_s* pool, void* block);		//  (Config) Hands a block back to `rx_pool`, installed by `isotp_pool_attach`
+
+	//	Zero-copy transmit
+	const isotp_tx_fragment_t* tx_fragments;	//  (Live) Borrowed fragments being transmitted (NULL = transmit from tx_buffer)
+	size_t tx_fragment_count;					//  (Live) Number of borrowed fragments
+	size_t tx_fragment_idx;						//  (Live) Fragment the next payload byte is read from
+	size_t tx_fragment_offset;					//  (Live) Offset of the next payload byte inside the current fragment
+	isotp_tx_fragment_t tx_fragment_borrowed;	//  (Live) Fragment storage for `isotp_session_send_borrowed`
+
+	//	Transmit queue
+	isotp_tx_message_t* tx_queue;				//  (Config) User provided ring of queued messages (NULL = no queue, see `isotp_session_use_tx_queue`)
+	size_t tx_queue_mask;						//  (Config) Ring capacity - 1 (capacity is a power of two)
+	size_t tx_queue_head;						//  (Live) Messages queued
+	size_t tx_queue_tail;						//  (Live) Messages ended
+	bool tx_queue_active;						//  (Live) Transmission in progress is the oldest queued message
+
+	//	Timers
+	uint64_t deadline_uS;						//  (Live) Time the armed timer expires (ISOTP_SESSION_DEADLINE_NONE = not armed)
+	isotp_session_timer_t deadline_timer;		//  (Live) Timer that is armed
+	struct isotp_timer_heap_s* timer_heap;		//  (Config) Heap tracking this session's deadline (NULL = none, see `isotp_timer_heap_attach`)
+	size_t timer_heap_idx;						//  (Live) Position inside `timer_heap`
+	uint64_t tx_next_due_uS;					//  (Live) Earliest time the next consecutive or FC WAIT frame may be sent (requires `callback_time_uS`)
+
+	//	Flow control
+	uint8_t fc_wait_count;						//  (Live) FC WAIT frames sent in a row
+	size_t rx_sequence_errors;					//  (Live) Out of order consecutive frames seen since init
+
+	//	Full duplex (the live fields above hold the transmission, and the reception while it is being processed)
+	isotp_session_direction_t duplex_parked;	//  (Live) State of the direction not held by the live fields (the reception, between calls)
+	bool duplex_rx_loaded;						//  (Live) Live fields hold the reception
+	uint8_t duplex_depth;						//  (Live) Nesting of session processing (0 = called by the application)
+	uint64_t duplex_deadline_uS[2];				//  (Live) Deadline of the transmission [0] and reception [1], `deadline_uS` is the earlier one
+	isotp_session_timer_t duplex_deadline_timer[2];	//  (Live) Timer armed for the transmission [0] and reception [1]
+
+#ifdef ISOTP_ENABLE_STATS
+	//	Statistics
+	isotp_session_stats_t stats;				//  (Live) Counters, read with `isotp_stats_snapshot`
+#endif
 
-	//  Current Session State
-	isotp_session_state_t state;			//  (Live) Current session state
-
-	//  Bidirectional parameters
-	uint16_t fc_allowed_frames_remaining;		//  (Live) Counter of frames that can be sent/recieved before flow control reqd (0 = FC needed, UINT16_MAX = FC not required)
-	uint8_t fc_idx_track_consecutive;			//	(Live) Index of last consecutive frame index sent/recieved
-	
-	uint8_t fc_requested_block_size;			//  (Config) Block size currently requested (0 = All frames)
-	uint32_t fc_requested_separation_uS;		//  (Config) Separation time currently requested (0 = No separation time)
-
-	size_t full_transmission_length;			//  (Live) Reported length of the transmission being sent/recieved
-	size_t buffer_offset;                		//  (Live) How many bytes have been sent/recieved from the current buffer
+#ifdef ISOTP_ENABLE_TRACE
+	//	Tracing
+	struct isotp_trace_ring_s* trace;			//  (Config) Ring frame-level events are recorded to (NULL = none, see `isotp_trace_attach`)
+	uint16_t trace_id;							//  (Config) Session id recorded with every event
+#endif
 } isotp_session_t;
 
 /**
- * @brief Resets entire session to default state, callbacks to NULL, and loads provided buffer data
+ * @brief Resets entire session to default state, callbacks to NULL (no `ops` table, the session as context), and loads provided buffer data
  * 
  * @param session 
  * @param tx_buffer 
@@ -166,6 +452,18 @@ typedef struct {
  */
 void isotp_session_init(isotp_session_t* session, const isotp_format_t frame_format, void* tx_buffer, size_t tx_len, void* rx_buffer, size_t rx_len);
 
+/**
+ * @brief Points the session at a shared const callback table instead of its own callback fields, and selects the
+ * context every callback receives. Sessions sharing a table tell each other apart by `user_context`, which callbacks
+ * must map back to their session themselves (e.g. `isotp_session_idle`). Built with ISOTP_SESSION_SHARED_OPS the
+ * session has no callback fields of its own, which shrinks it by the size of the table.
+ * 
+ * @param session Session to update
+ * @param ops Callback table, must remain valid while in use (NULL = the session's own callbacks, or no callbacks with ISOTP_SESSION_SHARED_OPS)
+ * @param user_context Context passed to every callback (NULL = the session itself)
+ */
+void isotp_session_use_ops(isotp_session_t* session, const isotp_session_ops_t* ops, void* user_context);
+
 /**
  * @brief Allows for live reconfiguration of the RX buffer. Intended to be used from len_rx callback to allow for dynamic buffer allocation if desired. Only works in idle & memory_config callback states.
  * 
@@ -178,10 +476,88 @@ void isotp_session_init(isotp_session_t* session, const isotp_format_t frame_for
 bool isotp_session_use_rx_buffer(isotp_session_t* session, void* rx_buffer, size_t rx_len);
 
 /**
- * @brief Resets session state to idle
+ * @brief Streams received payload into `rx_sink` instead of `rx_buffer`, so message size is not limited by RAM. `rx_sink` must remain valid while in use. Only works in idle & memory_config callback states.
+ * 
+ * @param session Session to update
+ * @param rx_sink Sink to stream into (NULL = return to `rx_buffer`)
+ * @return true Sink successfully configured
+ * @return false State not valid (not idle or memory_config callback) or sink has no `write`
+ */
+bool isotp_session_use_rx_sink(isotp_session_t* session, const isotp_rx_sink_t* rx_sink);
+
+/**
+ * @brief Receives into a set of slots instead of a single RX buffer, so a new message can arrive while earlier ones are
+ * being consumed. When a message completes, its slot is marked held and `callback_transmission_rx` runs with `rx_buffer`
+ * pointing at it. The session then returns to idle and the next message is recieved into a slot the application does
+ * not hold, without copying. Messages arriving while every slot is held are dropped through `callback_error_rx_busy`.
+ * Only works in idle & memory_config callback states.
+ * 
+ * @param session Session to update
+ * @param slots Slot storage with `buffer` and `size` filled in, must remain valid while in use (NULL = return to the current `rx_buffer` alone)
+ * @param slot_count Number of slots
+ * @return true Slots configured, all released
+ * @return false State not valid (not idle or memory_config callback), a slot has no memory or the session draws from a pool
+ */
+bool isotp_session_use_rx_slots(isotp_session_t* session, isotp_rx_slot_t* slots, const size_t slot_count);
+
+/**
+ * @brief Hands a recieved message's slot back to the session, or its block back to the session's pool. Safe to call from any thread, including from inside `callback_transmission_rx`.
+ * 
+ * @param session Session using slots or a pool
+ * @param buffer `rx_buffer` as seen in `callback_transmission_rx`
+ * @return true Slot or block released
+ * @return false Not a slot or pool block of this session, or slot not held
+ */
+bool isotp_session_release_rx(isotp_session_t* session, const void* buffer);
+
+/**
+ * @brief Gives the session a ring of message slots so messages can be queued while a transmission is in progress.
+ * Only works while no queued message is pending.
+ * 
+ * @param session Session to update
+ * @param messages Slot storage (NULL = remove the queue)
+ * @param capacity Number of slots, must be a power of two
+ * @return true Queue configured
+ * @return false Invalid capacity or queued messages pending
+ */
+bool isotp_session_use_tx_queue(isotp_session_t* session, isotp_tx_message_t* messages, const size_t capacity);
+
+/**
+ * @brief Queues a message without disturbing the transmission in progress. Queued messages are sent in order, each starting
+ * on the first `isotp_session_can_tx` call that finds the session idle, so back-to-back messages need no round trip
+ * through the application. Each message reports through its own `callback_complete` as well as `callback_transmission_tx`.
+ * A reception also keeps the session busy: queued messages wait until it is idled. Starting a transmission directly
+ * (`isotp_session_send` and friends) abandons a queued message in progress.
+ * 
+ * @param session Session with a queue (see `isotp_session_use_tx_queue`)
+ * @param message Message to queue, copied into a slot (`data` stays borrowed)
+ * @return true Message queued
+ * @return false No queue, queue full or empty message
+ */
+bool isotp_session_queue_send(isotp_session_t* session, const isotp_tx_message_t* message);
+
+/**
+ * @brief Number of queued messages, including the one being transmitted
+ * 
+ * @param session Session to query
+ * @return size_t Queued messages
+ */
+size_t isotp_session_tx_queue_count(const isotp_session_t* session);
+
+/**
+ * @brief Resets session state to idle. With `protocol_config.full_duplex`, ends both directions when called by the application, or only the direction being processed when called from a session callback.
  */
 void isotp_session_idle(isotp_session_t* session);
 
+/**
+ * @brief Expires the armed timer if its deadline has passed, running `callback_error_timeout`
+ * 
+ * @param session Session to check
+ * @param now_uS Current time from the same clock as `callback_time_uS`
+ * @return uint64_t Next deadline of the session (ISOTP_SESSION_DEADLINE_NONE = no timer armed)
+ */
+uint64_t isotp_session_tick(isotp_session_t* session, const uint64_t now_uS);
+
 /**
  * @brief Copies data to session tx buffer and starts transmission
  * 
@@ -192,6 +568,26 @@ void isotp_session_idle(isotp_session_t* session);
  */
 size_t isotp_session_send(isotp_session_t* session, const uint8_t* data, const size_t data_length);
 
+/**
+ * @brief Starts transmission directly from caller memory without copying into the session tx buffer. `data` must remain valid and unmodified until `callback_transmission_tx` runs.
+ * 
+ * @param session 
+ * @param data Payload to transmit
+ * @param data_length Payload length
+ * @return size_t Bytes queued for transmission (0 = invalid parameters)
+ */
+size_t isotp_session_send_borrowed(isotp_session_t* session, const uint8_t* data, const size_t data_length);
+
+/**
+ * @brief Starts transmission of a scatter-gather list of caller owned fragments as a single ISO-TP message. The fragment array and all fragment data must remain valid and unmodified until `callback_transmission_tx` runs.
+ * 
+ * @param session 
+ * @param fragments Fragments to transmit, in order
+ * @param fragment_count Number of fragments
+ * @return size_t Bytes queued for transmission (0 = invalid parameters or empty message)
+ */
+size_t isotp_session_send_fragments(isotp_session_t* session, const isotp_tx_fragment_t* fragments, const size_t fragment_count);
+
 /**
  * @brief Processes a recieved CAN frame and associated callbacks
  * 
@@ -202,7 +598,27 @@ size_t isotp_session_send(isotp_session_t* session, const uint8_t* data, const s
 void isotp_session_can_rx(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length);
 
 /**
- * @brief Fetches the next ISO-TP frame to transmit
+ * @brief Processes an array of recieved CAN frames back-to-back. Runs of in-order consecutive frames take a fast path and report a single `callback_peek_consecutive_frame` covering the whole run.
+ * A run ends at the end of `frames` (or at the first frame that leaves the fast path), so a transmission spread over several
+ * batches gets one peek per batch, not one per transmission. Raw frame hooks (`callback_can_rx` and tracing) still fire
+ * for every frame. Use `callback_transmission_rx` for a single callback per completed transmission.
+ * 
+ * @param session 
+ * @param frames Recieved frames, in bus order
+ * @param frame_count Number of frames
+ */
+void isotp_session_can_rx_batch(isotp_session_t* session, const isotp_can_frame_t* frames, const size_t frame_count);
+
+/**
+ * @brief Time at which the session next has a frame to send, so schedulers can sleep until then instead of polling
+ * 
+ * @param session Session to query
+ * @return uint64_t Due time on the `callback_time_uS` clock (0 = now, ISOTP_SESSION_DEADLINE_NONE = nothing to send until a frame is recieved or a send is started)
+ */
+uint64_t isotp_session_next_tx_due(const isotp_session_t* session);
+
+/**
+ * @brief Fetches the next ISO-TP frame to transmit. With `callback_time_uS` set, separation time is honored internally and no frame is returned before `isotp_session_next_tx_due`.
  * 
  * @param session Session to work with
  * @param frame_data Outputted frame data
@@ -211,6 +627,18 @@ void isotp_session_can_rx(isotp_session_t* session, const uint8_t* frame_data, c
  */
 size_t isotp_session_can_tx(isotp_session_t* session, uint8_t* frame_data, const size_t frame_size, uint32_t* requested_separation_uS);
 
+/**
+ * @brief Fetches as many ISO-TP frames as can be sent back-to-back in a single pass, so drivers can queue them in one burst. Stops when `max_frames` is reached, the transmission must wait for flow control, or a separation time is required before the next frame.
+ * 
+ * @param session Session to work with
+ * @param frames Outputted frames (`data` and `length` are set)
+ * @param max_frames Number of frame slots in `frames`
+ * @param frame_size Size of frame allowed (limited to `ISOTP_CAN_FRAME_MAX_SIZE`)
+ * @param requested_separation_uS Separation time required after the last frame returned
+ * @return size_t Number of frames produced
+ */
+size_t isotp_session_can_tx_batch(isotp_session_t* session, isotp_can_frame_t* frames, const size_t max_frames, const size_t frame_size, uint32_t* requested_separation_uS);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
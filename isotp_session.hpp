@@ -0,0 +1,268 @@
+#pragma once
+
+/*
+    ISO-TP Typed Sessions
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Header-only C++20 session wrapper with callbacks bound at compile time. A handler derives from
+    `isotp::session<Handler, Format>` (CRTP) and defines the callbacks it needs as member functions named after the
+    C callbacks, with `std::span` in place of pointer & length pairs:
+
+        class ecu : public isotp::session<ecu, ISOTP_FORMAT_FD> {
+        public:
+            ecu(std::span<uint8_t> rx) : session(rx) {}
+            void on_transmission_rx(std::span<const uint8_t> message) { ... }
+        };
+
+    Only the callbacks the handler defines are installed, each through a trampoline that calls the member directly. The
+    trampolines form one const callback table per handler type (see `isotp_session_use_ops`), shared by all its sessions.
+    `can_tx`/`can_rx` run on the `fixed_session` hot paths (see isotp_session_fixed.hpp) with `on_peek_consecutive_frame`
+    called without any function pointer, so consecutive frames are handled entirely inline.
+
+    Handler members (all optional but `on_transmission_rx`, errors default to `isotp_session_idle`):
+        on_transmission_rx(std::span<const uint8_t> message)        Session is idled on return if still RECEIVED
+        on_transmission_tx(bool completed)
+        on_tx_buffer(TxBuffer&& buffer)                             Buffer moved into `send` handed back once its transmission ended (destroyed if not defined)
+        on_error_invalid_frame(isotp_spec_frame_type_t type, std::span<const uint8_t> frame)
+        on_error_partner_aborted_transfer(std::span<const uint8_t> frame)
+        on_error_transmission_too_large(std::span<const uint8_t> frame, size_t requested_size)
+        on_error_consecutive_out_of_order(std::span<const uint8_t> frame, uint8_t expected_index, uint8_t recieved_index)
+        on_error_unexpected_frame_type(std::span<const uint8_t> frame)
+        on_error_timeout(isotp_session_timer_t timer)
+        on_error_rx_busy(std::span<const uint8_t> frame)
+        on_peek_first_frame(std::span<const uint8_t> data)
+        on_peek_consecutive_frame(std::span<const uint8_t> data, size_t start_idx)
+        on_peek_flow_control_frame()
+        on_can_rx(std::span<const uint8_t> frame)
+        on_can_tx(std::span<const uint8_t> frame)
+        on_mem_assign(size_t indicated_length)
+        on_fc_policy(isotp_fc_policy_t& policy)
+        time_uS()                                                   Monotonic clock, see `callback_time_uS`
+
+    Members must be accessible to `isotp::session` (public, or befriend it).
+*/
+
+#ifndef __cplusplus
+#error "isotp_session.hpp is designed to work in C++ environments only."
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <concepts>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+#include "isotp_session.h"
+#include "isotp_session_fixed.hpp"
+
+namespace isotp {
+
+namespace detail {
+
+//  Embedded C session, first base of `session` so callback contexts convert back to it
+struct session_storage {
+    isotp_session_t native;
+};
+
+}
+
+template <typename Handler, isotp_format_t Format, size_t FrameSize = (Format == ISOTP_FORMAT_FD) ? ISOTP_CAN_FRAME_MAX_SIZE : 8, bool Padding = true, typename TxBuffer = std::vector<uint8_t>>
+class session : private detail::session_storage {
+    static_assert(sizeof(*std::data(std::declval<TxBuffer&>())) == 1, "TxBuffer must be a contiguous container of bytes");
+
+public:
+    using fixed = fixed_session<Format, Padding, FrameSize>;
+    using tx_buffer_type = TxBuffer;
+
+    static constexpr size_t frame_size = FrameSize;
+
+    /**
+     * @brief Initializes the session (see `isotp_session_init`) and binds the handler's callbacks
+     *
+     * @param rx_buffer Receive buffer
+     * @param tx_buffer (Optional) Buffer `send` copies into, not needed for `send_borrowed` or owned sends
+     */
+    explicit session(std::span<uint8_t> rx_buffer, std::span<uint8_t> tx_buffer = {}) {
+        fixed::init(&native, tx_buffer.data(), tx_buffer.size(), rx_buffer.data(), rx_buffer.size());
+        bind();
+        isotp_session_idle(&native);
+    }
+
+    session(const session&) = delete;
+    session& operator=(const session&) = delete;
+
+    //  Underlying session, for configuration (`protocol_config`, timers, slots, ...). Its `ops` table and context must be kept.
+    isotp_session_t* native_session() { return &native; }
+    const isotp_session_t* native_session() const { return &native; }
+
+    /**
+     * @brief Copies `data` into the TX buffer and starts transmission (see `isotp_session_send`)
+     */
+    size_t send(std::span<const uint8_t> data) {
+        return isotp_session_send(&native, data.data(), data.size());
+    }
+
+    /**
+     * @brief Starts transmission straight from `data`, which must stay valid until `on_transmission_tx` (see `isotp_session_send_borrowed`)
+     */
+    size_t send_borrowed(std::span<const uint8_t> data) {
+        return isotp_session_send_borrowed(&native, data.data(), data.size());
+    }
+
+    /**
+     * @brief Takes ownership of `buffer` and transmits straight from it, without copying. The buffer is handed back
+     * through `on_tx_buffer` (or destroyed) once its transmission ended.
+     *
+     * @return size_t Bytes queued for transmission (0 = empty buffer, handed back at once)
+     */
+    size_t send(TxBuffer&& buffer) {
+        //  The previous transmission may still point at the owned buffer until it is ended below
+        const bool had_owned = std::exchange(tx_owned_active_, false);
+        TxBuffer previous = std::move(tx_owned_);
+        tx_owned_ = std::move(buffer);
+
+        const size_t sent = isotp_session_send_borrowed(&native, reinterpret_cast<const uint8_t*>(std::data(tx_owned_)), std::size(tx_owned_));
+        tx_owned_active_ = (sent > 0);
+
+        if(had_owned) { release_tx_buffer(std::move(previous)); }
+        if(sent == 0) { release_tx_buffer(std::move(tx_owned_)); }
+        return sent;
+    }
+
+    /**
+     * @brief Fetches the next frame to transmit, `frame` must hold `FrameSize` bytes (see `fixed_session::can_tx`)
+     */
+    size_t can_tx(std::span<uint8_t, FrameSize> frame, uint32_t* requested_separation_uS = nullptr) {
+        return fixed::can_tx(&native, frame.data(), requested_separation_uS);
+    }
+
+    /**
+     * @brief Processes a recieved frame (see `fixed_session::can_rx`)
+     */
+    void can_rx(std::span<const uint8_t> frame) {
+        fixed::can_rx(&native, frame.data(), frame.size(), [this](const uint8_t* data, const size_t length, const size_t start_idx) {
+            if constexpr(requires(Handler& h) { h.on_peek_consecutive_frame(std::span<const uint8_t>(), size_t()); }) {
+                handler().on_peek_consecutive_frame(std::span<const uint8_t>(data, length), start_idx);
+            }
+        });
+    }
+
+    void idle() { isotp_session_idle(&native); }
+    uint64_t tick(const uint64_t now_uS) { return isotp_session_tick(&native, now_uS); }
+    uint64_t next_tx_due() const { return isotp_session_next_tx_due(&native); }
+    isotp_session_state_t state() const { return native.state; }
+
+protected:
+    ~session() = default;
+
+private:
+    Handler& handler() { return static_cast<Handler&>(*this); }
+
+    static session& from(void* context) {
+        return static_cast<session&>(*reinterpret_cast<detail::session_storage*>(static_cast<isotp_session_t*>(context)));
+    }
+
+    static Handler& handler_of(void* context) { return from(context).handler(); }
+
+    static std::span<const uint8_t> bytes(const uint8_t* data, const size_t length) { return std::span<const uint8_t>(data, length); }
+
+    void release_tx_buffer(TxBuffer&& buffer) {
+        if constexpr(requires(Handler& h, TxBuffer&& b) { h.on_tx_buffer(std::move(b)); }) {
+            handler().on_tx_buffer(std::move(buffer));
+        }
+        else {
+            TxBuffer released = std::move(buffer);
+        }
+    }
+
+    //  Trampolines (only installed for members the handler defines)
+    static void on_transmission_rx(void* context) {
+        isotp_session_t* native = static_cast<isotp_session_t*>(context);
+        handler_of(context).on_transmission_rx(bytes(static_cast<const uint8_t*>(native->rx_buffer), native->full_transmission_length));
+        if(native->state == ISOTP_SESSION_RECEIVED) { isotp_session_idle(native); }
+    }
+
+    static void on_transmission_tx(void* context, const bool completed) {
+        session& self = from(context);
+        if(!self.tx_owned_active_) {
+            if constexpr(requires(Handler& h) { h.on_transmission_tx(bool()); }) { self.handler().on_transmission_tx(completed); }
+            return;
+        }
+
+        //  Ownership returns before the handler may start the next send
+        self.tx_owned_active_ = false;
+        TxBuffer buffer = std::move(self.tx_owned_);
+        if constexpr(requires(Handler& h) { h.on_transmission_tx(bool()); }) { self.handler().on_transmission_tx(completed); }
+        self.release_tx_buffer(std::move(buffer));
+    }
+
+    static void on_error_invalid_frame(void* context, const isotp_spec_frame_type_t type, const uint8_t* data, const size_t length) { handler_of(context).on_error_invalid_frame(type, bytes(data, length)); }
+    static void on_error_partner_aborted_transfer(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_error_partner_aborted_transfer(bytes(data, length)); }
+    static void on_error_transmission_too_large(void* context, const uint8_t* data, const size_t length, const size_t requested_size) { handler_of(context).on_error_transmission_too_large(bytes(data, length), requested_size); }
+    static void on_error_consecutive_out_of_order(void* context, const uint8_t* data, const size_t length, const uint8_t expected_index, const uint8_t recieved_index) { handler_of(context).on_error_consecutive_out_of_order(bytes(data, length), expected_index, recieved_index); }
+    static void on_error_unexpected_frame_type(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_error_unexpected_frame_type(bytes(data, length)); }
+    static void on_error_timeout(void* context, const isotp_session_timer_t timer) { handler_of(context).on_error_timeout(timer); }
+    static void on_error_rx_busy(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_error_rx_busy(bytes(data, length)); }
+    static void on_peek_first_frame(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_peek_first_frame(bytes(data, length)); }
+    static void on_peek_consecutive_frame(void* context, const uint8_t* data, const size_t length, const size_t start_idx) { handler_of(context).on_peek_consecutive_frame(bytes(data, length), start_idx); }
+    static void on_peek_flow_control_frame(void* context) { handler_of(context).on_peek_flow_control_frame(); }
+    static void on_can_rx(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_can_rx(bytes(data, length)); }
+    static void on_can_tx(void* context, const uint8_t* data, const size_t length) { handler_of(context).on_can_tx(bytes(data, length)); }
+    static void on_mem_assign(void* context, const size_t indicated_length) { handler_of(context).on_mem_assign(indicated_length); }
+    static void on_fc_policy(void* context, isotp_fc_policy_t* policy) { handler_of(context).on_fc_policy(*policy); }
+    static uint64_t time_uS(void* context) { return handler_of(context).time_uS(); }
+
+    //  Defaults of required callbacks: cancel
+    static void idle_invalid_frame(void* context, const isotp_spec_frame_type_t, const uint8_t*, const size_t) { isotp_session_idle(static_cast<isotp_session_t*>(context)); }
+    static void idle_error(void* context, const uint8_t*, const size_t) { isotp_session_idle(static_cast<isotp_session_t*>(context)); }
+    static void idle_too_large(void* context, const uint8_t*, const size_t, const size_t) { isotp_session_idle(static_cast<isotp_session_t*>(context)); }
+    static void idle_out_of_order(void* context, const uint8_t*, const size_t, const uint8_t, const uint8_t) { isotp_session_idle(static_cast<isotp_session_t*>(context)); }
+
+    //  Callback table shared by every session of this handler type
+    static constexpr isotp_session_ops_t make_ops() {
+        static_assert(requires(Handler& h) { h.on_transmission_rx(std::span<const uint8_t>()); }, "Handler must define on_transmission_rx(std::span<const uint8_t>)");
+        static_assert(std::is_base_of_v<session, Handler>, "Handler must derive from isotp::session<Handler, ...>");
+
+        isotp_session_ops_t ops{};
+        const std::span<const uint8_t> frame;
+        ops.callback_transmission_rx = on_transmission_rx;
+        ops.callback_transmission_tx = on_transmission_tx;
+
+        //  Required
+        if constexpr(requires(Handler& h) { h.on_error_invalid_frame(isotp_spec_frame_type_t(), frame); }) { ops.callback_error_invalid_frame = on_error_invalid_frame; }
+        else { ops.callback_error_invalid_frame = idle_invalid_frame; }
+        if constexpr(requires(Handler& h) { h.on_error_partner_aborted_transfer(frame); }) { ops.callback_error_partner_aborted_transfer = on_error_partner_aborted_transfer; }
+        else { ops.callback_error_partner_aborted_transfer = idle_error; }
+        if constexpr(requires(Handler& h) { h.on_error_transmission_too_large(frame, size_t()); }) { ops.callback_error_transmission_too_large = on_error_transmission_too_large; }
+        else { ops.callback_error_transmission_too_large = idle_too_large; }
+        if constexpr(requires(Handler& h) { h.on_error_consecutive_out_of_order(frame, uint8_t(), uint8_t()); }) { ops.callback_error_consecutive_out_of_order = on_error_consecutive_out_of_order; }
+        else { ops.callback_error_consecutive_out_of_order = idle_out_of_order; }
+        if constexpr(requires(Handler& h) { h.on_error_unexpected_frame_type(frame); }) { ops.callback_error_unexpected_frame_type = on_error_unexpected_frame_type; }
+        else { ops.callback_error_unexpected_frame_type = idle_error; }
+
+        //  Optional
+        if constexpr(requires(Handler& h) { h.on_error_timeout(isotp_session_timer_t()); }) { ops.callback_error_timeout = on_error_timeout; }
+        if constexpr(requires(Handler& h) { h.on_error_rx_busy(frame); }) { ops.callback_error_rx_busy = on_error_rx_busy; }
+        if constexpr(requires(Handler& h) { h.on_peek_first_frame(frame); }) { ops.callback_peek_first_frame = on_peek_first_frame; }
+        if constexpr(requires(Handler& h) { h.on_peek_consecutive_frame(frame, size_t()); }) { ops.callback_peek_consecutive_frame = on_peek_consecutive_frame; }
+        if constexpr(requires(Handler& h) { h.on_peek_flow_control_frame(); }) { ops.callback_peek_flow_control_frame = on_peek_flow_control_frame; }
+        if constexpr(requires(Handler& h) { h.on_can_rx(frame); }) { ops.callback_can_rx = on_can_rx; }
+        if constexpr(requires(Handler& h) { h.on_can_tx(frame); }) { ops.callback_can_tx = on_can_tx; }
+        if constexpr(requires(Handler& h) { h.on_mem_assign(size_t()); }) { ops.callback_mem_assign = on_mem_assign; }
+        if constexpr(requires(Handler& h, isotp_fc_policy_t& p) { h.on_fc_policy(p); }) { ops.callback_fc_policy = on_fc_policy; }
+        if constexpr(requires(Handler& h) { { h.time_uS() } -> std::convertible_to<uint64_t>; }) { ops.callback_time_uS = time_uS; }
+
+        return ops;
+    }
+
+    void bind() {
+        static constexpr isotp_session_ops_t ops = make_ops();
+        isotp_session_use_ops(&native, &ops, nullptr);
+    }
+
+    TxBuffer tx_owned_{};               //  Buffer moved into `send`, transmitted from while `tx_owned_active_`
+    bool tx_owned_active_ = false;
+};
+
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+/*
+    ISO-TP Fixed Format Sessions
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Header-only C++ specializations of the session hot paths for nodes that only ever speak a single frame format.
+
+    `isotp::fixed_session<Format, Padding, FrameSize>` works on a regular `isotp_session_t`. Consecutive frames,
+    which make up nearly all traffic of a large transfer, are built and consumed with the frame format, padding
+    and frame size folded in at compile time. Every other frame, and any session feature that needs the generic
+    state machine (clock, sink, multi-fragment sends, extended or mixed addressing, full duplex), is passed on to `isotp_session_can_tx`/`isotp_session_can_rx`
+    so behavior is identical to the C API. The session's protocol_config must match the template parameters
+    (see `fixed_session::init` and `fixed_session::matches`).
+*/
+
+#ifndef __cplusplus
+#error "isotp_session_fixed.hpp is designed to work in C++ environments only."
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "isotp_session.h"
+#include "isotp_conversions.h"
+#include "isotp_stats.h"
+#include "isotp_trace.h"
+
+namespace isotp {
+
+template <isotp_format_t Format, bool Padding, size_t FrameSize>
+struct fixed_session {
+    static_assert(FrameSize > ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, "Frame size too small for a consecutive frame");
+    static_assert(FrameSize <= ISOTP_CAN_FRAME_MAX_SIZE, "Frame size exceeds ISOTP_CAN_FRAME_MAX_SIZE");
+    static_assert(Format == ISOTP_FORMAT_FD || FrameSize <= 8, "Only CAN FD frames may exceed 8 bytes");
+
+    //  Payload bytes carried by a full consecutive frame
+    static constexpr size_t consecutive_payload = FrameSize - ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX;
+
+    /**
+     * @brief Initializes `session` with a protocol_config matching the template parameters (see `isotp_session_init`)
+     */
+    static void init(isotp_session_t* session, void* tx_buffer, size_t tx_len, void* rx_buffer, size_t rx_len) {
+        isotp_session_init(session, Format, tx_buffer, tx_len, rx_buffer, rx_len);
+        session->protocol_config.padding_enabled = Padding;
+    }
+
+    /**
+     * @brief Whether the session's protocol_config matches the template parameters
+     */
+    static bool matches(const isotp_session_t* session) {
+        return session != nullptr && session->protocol_config.frame_format == Format && session->protocol_config.padding_enabled == Padding;
+    }
+
+    /**
+     * @brief Fetches the next ISO-TP frame to transmit into a `FrameSize` buffer (see `isotp_session_can_tx`)
+     */
+    static size_t can_tx(isotp_session_t* session, uint8_t* frame_data, uint32_t* requested_separation_uS = nullptr) {
+        const uint8_t* source = tx_fast_source(session);
+        if(source == nullptr || frame_data == nullptr) {
+            return isotp_session_can_tx(session, frame_data, FrameSize, requested_separation_uS);
+        }
+
+        //  Payload length (only the final frame is short)
+        const size_t bytes_remaining = session->full_transmission_length - session->buffer_offset;
+        const size_t packet_len = (bytes_remaining < consecutive_payload) ? bytes_remaining : consecutive_payload;
+
+        //  Header & data
+        frame_data[ISOTP_SPEC_FRAME_TYPE_IDX] = (uint8_t)((ISOTP_SPEC_FRAME_CONSECUTIVE << ISOTP_SPEC_FRAME_TYPE_SHIFT) | (session->fc_idx_track_consecutive & ISOTP_SPEC_FRAME_CONSECUTIVE_INDEX_MASK));
+        memcpy(frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, source, packet_len);
+
+        size_t frame_length = ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX + packet_len;
+        const size_t padded_length = padded_frame_length(frame_length);
+        if(frame_length < padded_length) {
+            memset(frame_data + frame_length, session->protocol_config.padding_byte, padded_length - frame_length);
+            frame_length = padded_length;
+        }
+
+        //  Advance buffer
+        session->buffer_offset += packet_len;
+        session->tx_fragment_offset += (session->tx_fragments != nullptr) ? packet_len : 0;
+        ISOTP_STATS_INC(session, frames_tx[ISOTP_SPEC_FRAME_CONSECUTIVE]);
+        ISOTP_STATS_ADD(session, bytes_tx, packet_len);
+
+        //  Increment index
+        session->fc_idx_track_consecutive++;
+        if(session->fc_idx_track_consecutive > session->protocol_config.consecutive_index_end) {
+            session->fc_idx_track_consecutive = session->protocol_config.consecutive_index_start;
+        }
+
+        //  Flow control (LIN does not have FC)
+        if(session->fc_allowed_frames_remaining > 0 && session->fc_allowed_frames_remaining != UINT16_MAX) {
+            session->fc_allowed_frames_remaining--;
+        }
+
+        if(Format != ISOTP_FORMAT_LIN && session->fc_allowed_frames_remaining == 0) {
+            ISOTP_TRACE_STATE(session, ISOTP_SESSION_TRANSMITTING_AWAITING_FC);
+            session->state = ISOTP_SESSION_TRANSMITTING_AWAITING_FC;
+        }
+
+        //  Desired separation time
+        if(requested_separation_uS != nullptr) { *requested_separation_uS = session->fc_requested_separation_uS; }
+
+        //  Done
+        if(session->buffer_offset >= session->full_transmission_length) {
+            ISOTP_STATS_INC(session, transfers_tx);
+            isotp_session_idle(session);
+        }
+
+        //  Trace & CAN TX callback
+        ISOTP_TRACE(session, ISOTP_TRACE_FRAME_TX, frame_length, frame_data, frame_length);
+        if(ISOTP_SESSION_CALLBACK(session, callback_can_tx) != nullptr) { ISOTP_SESSION_CALLBACK(session, callback_can_tx)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
+
+        return frame_length;
+    }
+
+    /**
+     * @brief Processes a recieved CAN frame (see `isotp_session_can_rx`)
+     */
+    static void can_rx(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
+        can_rx(session, frame_data, frame_length, [session](const uint8_t* data, const size_t length, const size_t start_idx) {
+            if(ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame) != nullptr) { ISOTP_SESSION_CALLBACK(session, callback_peek_consecutive_frame)(ISOTP_SESSION_CONTEXT(session), data, length, start_idx); }
+        });
+    }
+
+    /**
+     * @brief Processes a recieved CAN frame, reporting fast path consecutive frames to `peek_consecutive` (called as
+     * `callback_peek_consecutive_frame` without the context) instead of the session's callback, so it can be inlined
+     */
+    template <typename PeekConsecutive>
+    static void can_rx(isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length, PeekConsecutive&& peek_consecutive) {
+        if(!rx_fast_eligible(session, frame_data, frame_length)) {
+            isotp_session_can_rx(session, frame_data, frame_length);
+            return;
+        }
+
+        //  Callback & trace
+        if(ISOTP_SESSION_CALLBACK(session, callback_can_rx) != nullptr) { ISOTP_SESSION_CALLBACK(session, callback_can_rx)(ISOTP_SESSION_CONTEXT(session), frame_data, frame_length); }
+        ISOTP_TRACE(session, ISOTP_TRACE_FRAME_RX, frame_length, frame_data, frame_length);
+
+        //  Copy full frame payload (constant size)
+        const size_t start_idx = session->buffer_offset;
+        memcpy((uint8_t*)session->rx_buffer + start_idx, frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, consecutive_payload);
+        session->buffer_offset += consecutive_payload;
+        ISOTP_STATS_INC(session, frames_rx[ISOTP_SPEC_FRAME_CONSECUTIVE]);
+        ISOTP_STATS_ADD(session, bytes_rx, consecutive_payload);
+
+        //  Increment expected index
+        session->fc_idx_track_consecutive++;
+        if(session->fc_idx_track_consecutive > session->protocol_config.consecutive_index_end) {
+            session->fc_idx_track_consecutive = session->protocol_config.consecutive_index_start;
+        }
+
+        //  Decrement flow control counter
+        if(session->fc_allowed_frames_remaining > 0 && session->fc_allowed_frames_remaining != UINT16_MAX) {
+            session->fc_allowed_frames_remaining--;
+        }
+
+        //  Peek callback
+        peek_consecutive(frame_data + ISOTP_SPEC_FRAME_CONSECUTIVE_DATASTART_IDX, consecutive_payload, start_idx);
+    }
+
+private:
+    //  Length a frame goes out with (CAN FD only pads up to the next data length step, and must past 8 bytes)
+    static size_t padded_frame_length(const size_t frame_length) {
+        if(Format == ISOTP_FORMAT_FD) {
+            if(frame_length > ISOTP_SPEC_FD_DLC_CLASSIC_MAX) {
+                const size_t step = isotp_spec_fd_frame_length(frame_length);
+                return (step < FrameSize) ? step : FrameSize;
+            }
+
+            return Padding ? ISOTP_SPEC_FD_DLC_CLASSIC_MAX : frame_length;
+        }
+
+        return Padding ? FrameSize : frame_length;
+    }
+
+    //  Source of the next consecutive frame payload, or NULL if the generic path is required
+    static const uint8_t* tx_fast_source(const isotp_session_t* session) {
+        if(session == nullptr || session->state != ISOTP_SESSION_TRANSMITTING || session->buffer_offset == 0 || ISOTP_SESSION_CALLBACK(session, callback_time_uS) != nullptr) {
+            return nullptr;
+        }
+
+        //  Frame layout is folded in for normal addressing only, full duplex needs the generic direction handling
+        if(session->protocol_config.addressing_mode != ISOTP_ADDRESSING_NORMAL || session->protocol_config.full_duplex) {
+            return nullptr;
+        }
+
+        //  Message planned with another frame size
+        if(session->tx_frame_size != 0 && session->tx_frame_size != FrameSize) {
+            return nullptr;
+        }
+
+        //  Owned tx buffer
+        if(session->tx_fragments == nullptr) {
+            return (const uint8_t*)session->tx_buffer + session->buffer_offset;
+        }
+
+        //  Single borrowed buffer
+        if(session->tx_fragment_count == 1) {
+            return session->tx_fragments[0].data + session->buffer_offset;
+        }
+
+        return nullptr;
+    }
+
+    //  Full size, in-order consecutive frame that does not complete the transmission
+    static bool rx_fast_eligible(const isotp_session_t* session, const uint8_t* frame_data, const size_t frame_length) {
+        if(session == nullptr || frame_data == nullptr || frame_length != FrameSize) {
+            return false;
+        }
+
+        if(session->state != ISOTP_SESSION_RECEIVING || session->rx_sink != nullptr || ISOTP_SESSION_CALLBACK(session, callback_time_uS) != nullptr) {
+            return false;
+        }
+
+        if(session->protocol_config.addressing_mode != ISOTP_ADDRESSING_NORMAL || session->protocol_config.full_duplex) {
+            return false;
+        }
+
+        const uint8_t header = frame_data[ISOTP_SPEC_FRAME_TYPE_IDX];
+        if(((header & ISOTP_SPEC_FRAME_TYPE_MASK) >> ISOTP_SPEC_FRAME_TYPE_SHIFT) != ISOTP_SPEC_FRAME_CONSECUTIVE ||
+           (header & ISOTP_SPEC_FRAME_CONSECUTIVE_INDEX_MASK) != session->fc_idx_track_consecutive) {
+            return false;
+        }
+
+        return consecutive_payload < session->full_transmission_length - session->buffer_offset &&
+               consecutive_payload <= session->rx_len - session->buffer_offset;
+    }
+};
+
+//  Common node configurations
+typedef fixed_session<ISOTP_FORMAT_NORMAL, true, 8> classic_padded_session;
+typedef fixed_session<ISOTP_FORMAT_NORMAL, false, 8> classic_session;
+typedef fixed_session<ISOTP_FORMAT_FD, true, 64> fd64_padded_session;
+typedef fixed_session<ISOTP_FORMAT_LIN, true, 8> lin_session;
+
+}
@@ -0,0 +1,490 @@
+#if defined(__linux__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <linux/can/raw.h>
+#include "isotp_socketcan.h"
+
+//  Maximum events handled per `isotp_socketcan_loop_run_once`
+#define SOCKETCAN_LOOP_EVENTS 16
+
+//  Router identifier (ISOTP_ROUTER_ID_FLAG_EXTENDED for 29-bit) to SocketCAN identifier
+static inline canid_t socketcan_id_from_router(const uint32_t identifier) {
+    if(identifier & ISOTP_ROUTER_ID_FLAG_EXTENDED) {
+        return (identifier & CAN_EFF_MASK) | CAN_EFF_FLAG;
+    }
+
+    return identifier & CAN_SFF_MASK;
+}
+
+//  SocketCAN identifier to router identifier
+static inline uint32_t socketcan_id_to_router(const canid_t can_id) {
+    if(can_id & CAN_EFF_FLAG) {
+        return (can_id & CAN_EFF_MASK) | ISOTP_ROUTER_ID_FLAG_EXTENDED;
+    }
+
+    return can_id & CAN_SFF_MASK;
+}
+
+//  Enable or disable EPOLLOUT interest while frames are stuck in the socket
+static void socketcan_wait_writable(isotp_socketcan_t* iface, const bool wait) {
+    if(iface->tx_wait_writable == wait) {
+        return;
+    }
+
+    iface->tx_wait_writable = wait;
+
+    if(iface->loop != NULL) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | (wait ? EPOLLOUT : 0);
+        ev.data.ptr = iface;
+        epoll_ctl(iface->loop->epoll_fd, EPOLL_CTL_MOD, iface->socket_fd, &ev);
+    }
+}
+
+uint64_t isotp_socketcan_time_uS(void* context) {
+    (void)context;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+bool isotp_socketcan_open(isotp_socketcan_t* iface, const char* ifname, isotp_router_t* router, const bool fd_frames, struct can_filter* filters, const size_t filter_capacity) {
+    //  Safety
+    if(iface == NULL || ifname == NULL || router == NULL) {
+        return false;
+    }
+
+    memset(iface, 0, sizeof(isotp_socketcan_t));
+    iface->socket_fd = -1;
+    iface->router = router;
+    iface->fd_frames = fd_frames;
+    iface->filters = filters;
+    iface->filter_capacity = (filters != NULL) ? filter_capacity : 0;
+    iface->tx_retry_uS = ISOTP_SESSION_DEADLINE_NONE;
+
+    //  Resolve interface
+    const unsigned int ifindex = if_nametoindex(ifname);
+    if(ifindex == 0) {
+        return false;
+    }
+
+    //  Socket
+    iface->socket_fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if(iface->socket_fd < 0) {
+        return false;
+    }
+
+    if(fd_frames) {
+        const int enable = 1;
+        if(setsockopt(iface->socket_fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0) {
+            isotp_socketcan_close(iface);
+            return false;
+        }
+    }
+
+    //  Filter before bind so no unwanted frames are queued
+    isotp_socketcan_update_filters(iface);
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = (int)ifindex;
+
+    if(bind(iface->socket_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        isotp_socketcan_close(iface);
+        return false;
+    }
+
+    return true;
+}
+
+void isotp_socketcan_close(isotp_socketcan_t* iface) {
+    //  Safety
+    if(iface == NULL || iface->socket_fd < 0) {
+        return;
+    }
+
+    close(iface->socket_fd);
+    iface->socket_fd = -1;
+    iface->tx_pending_idx = 0;
+    iface->tx_pending_count = 0;
+}
+
+bool isotp_socketcan_update_filters(isotp_socketcan_t* iface) {
+    //  Safety
+    if(iface == NULL || iface->socket_fd < 0 || iface->router == NULL) {
+        return false;
+    }
+
+    //  Filtering not requested
+    if(iface->filters == NULL) {
+        return true;
+    }
+
+    //  Storage too small, fall back to accepting everything (router drops unknown IDs)
+    if(iface->router->count > iface->filter_capacity) {
+        struct can_filter accept_all = { 0, 0 };
+        setsockopt(iface->socket_fd, SOL_CAN_RAW, CAN_RAW_FILTER, &accept_all, sizeof(accept_all));
+        return false;
+    }
+
+    //  One exact match filter per session, RTR frames never match
+    size_t count = 0;
+    for(size_t idx = 0; idx < iface->router->capacity; idx++) {
+        const isotp_router_entry_t* entry = &iface->router->entries[idx];
+        if(entry->session == NULL) {
+            continue;
+        }
+
+        const bool extended = (entry->rx_id & ISOTP_ROUTER_ID_FLAG_EXTENDED) != 0;
+        iface->filters[count].can_id = socketcan_id_from_router(entry->rx_id);
+        iface->filters[count].can_mask = (extended ? CAN_EFF_MASK : CAN_SFF_MASK) | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        count++;
+    }
+
+    //  Zero filters = receive nothing
+    if(setsockopt(iface->socket_fd, SOL_CAN_RAW, CAN_RAW_FILTER, (count > 0) ? iface->filters : NULL, (socklen_t)(count * sizeof(struct can_filter))) < 0) {
+        struct can_filter accept_all = { 0, 0 };
+        setsockopt(iface->socket_fd, SOL_CAN_RAW, CAN_RAW_FILTER, &accept_all, sizeof(accept_all));
+        return false;
+    }
+
+    return true;
+}
+
+size_t isotp_socketcan_receive(isotp_socketcan_t* iface) {
+    //  Safety
+    if(iface == NULL || iface->socket_fd < 0) {
+        return 0;
+    }
+
+    isotp_can_frame_t frames[ISOTP_SOCKETCAN_BATCH_SIZE];
+    struct iovec iov[ISOTP_SOCKETCAN_BATCH_SIZE];
+    struct mmsghdr msgs[ISOTP_SOCKETCAN_BATCH_SIZE];
+    size_t received = 0;
+
+    memset(msgs, 0, sizeof(msgs));
+    for(size_t i = 0; i < ISOTP_SOCKETCAN_BATCH_SIZE; i++) {
+        iov[i].iov_base = &iface->rx_frames[i];
+        iov[i].iov_len = sizeof(struct canfd_frame);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while(true) {
+        const int n = recvmmsg(iface->socket_fd, msgs, ISOTP_SOCKETCAN_BATCH_SIZE, MSG_DONTWAIT, NULL);
+        if(n <= 0) {
+            break;
+        }
+
+        //  Convert, skipping error and remote frames
+        size_t count = 0;
+        for(int i = 0; i < n; i++) {
+            const struct canfd_frame* frame = &iface->rx_frames[i];
+            const unsigned int msg_len = msgs[i].msg_len;
+
+            if((msg_len != CAN_MTU && msg_len != CANFD_MTU) || (frame->can_id & (CAN_ERR_FLAG | CAN_RTR_FLAG))) {
+                continue;
+            }
+
+            const size_t length = (frame->len > ISOTP_CAN_FRAME_MAX_SIZE) ? ISOTP_CAN_FRAME_MAX_SIZE : frame->len;
+            frames[count].identifier = socketcan_id_to_router(frame->can_id);
+            frames[count].length = (uint8_t)length;
+            memcpy(frames[count].data, frame->data, length);
+            count++;
+        }
+
+        isotp_router_can_rx_batch(iface->router, frames, count);
+        received += (size_t)n;
+
+        //  Socket drained
+        if(n < ISOTP_SOCKETCAN_BATCH_SIZE) {
+            break;
+        }
+    }
+
+    return received;
+}
+
+size_t isotp_socketcan_flush(isotp_socketcan_t* iface) {
+    //  Safety
+    if(iface == NULL || iface->socket_fd < 0) {
+        return 0;
+    }
+
+    const size_t frame_size = iface->fd_frames ? CANFD_MAX_DLEN : CAN_MAX_DLEN;
+    struct iovec iov[ISOTP_SOCKETCAN_BATCH_SIZE];
+    struct mmsghdr msgs[ISOTP_SOCKETCAN_BATCH_SIZE];
+    size_t sent = 0;
+
+    memset(msgs, 0, sizeof(msgs));
+    for(size_t i = 0; i < ISOTP_SOCKETCAN_BATCH_SIZE; i++) {
+        iov[i].iov_base = &iface->tx_frames[i];
+        iov[i].iov_len = iface->fd_frames ? CANFD_MTU : CAN_MTU;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while(true) {
+        //  Refill batch from the router once everything pending went out
+        if(iface->tx_pending_idx >= iface->tx_pending_count) {
+            size_t count = 0;
+
+            while(count < ISOTP_SOCKETCAN_BATCH_SIZE) {
+                struct canfd_frame* frame = &iface->tx_frames[count];
+                uint32_t identifier = 0;
+
+                const size_t len = isotp_router_can_tx(iface->router, &identifier, frame->data, frame_size, NULL);
+                if(len == 0) {
+                    break;
+                }
+
+                frame->can_id = socketcan_id_from_router(identifier);
+                frame->len = (uint8_t)len;
+                frame->flags = iface->fd_frames ? iface->fd_flags : 0;
+                frame->__res0 = 0;
+                frame->__res1 = 0;
+                count++;
+            }
+
+            iface->tx_pending_idx = 0;
+            iface->tx_pending_count = count;
+
+            //  Nothing due
+            if(count == 0) {
+                break;
+            }
+        }
+
+        //  Send
+        const int n = sendmmsg(iface->socket_fd, &msgs[iface->tx_pending_idx], (unsigned int)(iface->tx_pending_count - iface->tx_pending_idx), MSG_DONTWAIT);
+        if(n < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                //  Socket buffer full, resume on EPOLLOUT
+                socketcan_wait_writable(iface, true);
+            }
+            else if(errno == ENOBUFS) {
+                //  Interface queue full, the kernel does not signal EPOLLOUT for this
+                iface->tx_retry_uS = isotp_socketcan_time_uS(NULL) + ISOTP_SOCKETCAN_TX_RETRY_uS;
+            }
+            else {
+                //  Interface down, drop pending frames and let session timeouts recover
+                iface->tx_pending_idx = 0;
+                iface->tx_pending_count = 0;
+            }
+
+            return sent;
+        }
+
+        iface->tx_pending_idx += (size_t)n;
+        sent += (size_t)n;
+    }
+
+    //  All pending frames sent
+    iface->tx_retry_uS = ISOTP_SESSION_DEADLINE_NONE;
+    socketcan_wait_writable(iface, false);
+
+    return sent;
+}
+
+bool isotp_socketcan_loop_init(isotp_socketcan_loop_t* loop, isotp_timer_heap_t* timer_heap) {
+    //  Safety
+    if(loop == NULL) {
+        return false;
+    }
+
+    loop->interfaces = NULL;
+    loop->timer_heap = timer_heap;
+    loop->timer_fd = -1;
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(loop->epoll_fd < 0) {
+        return false;
+    }
+
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(loop->timer_fd < 0) {
+        isotp_socketcan_loop_close(loop);
+        return false;
+    }
+
+    //  Timer events are tagged with the loop itself
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = loop;
+
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->timer_fd, &ev) < 0) {
+        isotp_socketcan_loop_close(loop);
+        return false;
+    }
+
+    return true;
+}
+
+bool isotp_socketcan_loop_add(isotp_socketcan_loop_t* loop, isotp_socketcan_t* iface) {
+    //  Safety
+    if(loop == NULL || loop->epoll_fd < 0 || iface == NULL || iface->socket_fd < 0 || iface->loop != NULL) {
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | (iface->tx_wait_writable ? EPOLLOUT : 0);
+    ev.data.ptr = iface;
+
+    if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, iface->socket_fd, &ev) < 0) {
+        return false;
+    }
+
+    iface->loop = loop;
+    iface->next = loop->interfaces;
+    loop->interfaces = iface;
+
+    return true;
+}
+
+void isotp_socketcan_loop_remove(isotp_socketcan_loop_t* loop, isotp_socketcan_t* iface) {
+    //  Safety
+    if(loop == NULL || iface == NULL || iface->loop != loop) {
+        return;
+    }
+
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, iface->socket_fd, NULL);
+
+    //  Unlink
+    isotp_socketcan_t** link = &loop->interfaces;
+    while(*link != NULL && *link != iface) {
+        link = &(*link)->next;
+    }
+
+    if(*link == iface) {
+        *link = iface->next;
+    }
+
+    iface->loop = NULL;
+    iface->next = NULL;
+}
+
+//  Transmit everything due on every interface and re-arm the timer for the next deadline
+static void socketcan_loop_transmit(isotp_socketcan_loop_t* loop, const uint64_t now_uS, uint64_t deadline_uS) {
+    for(isotp_socketcan_t* iface = loop->interfaces; iface != NULL; iface = iface->next) {
+        //  Frames stuck in the socket wait for EPOLLOUT or the ENOBUFS retry
+        if(!iface->tx_wait_writable && (iface->tx_retry_uS == ISOTP_SESSION_DEADLINE_NONE || iface->tx_retry_uS <= now_uS)) {
+            isotp_socketcan_flush(iface);
+        }
+
+        uint64_t due_uS = (iface->tx_pending_idx < iface->tx_pending_count) ? iface->tx_retry_uS : isotp_router_next_tx_due(iface->router);
+        if(due_uS < deadline_uS) {
+            deadline_uS = due_uS;
+        }
+    }
+
+    //  Absolute, a deadline in the past fires immediately
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if(deadline_uS != ISOTP_SESSION_DEADLINE_NONE) {
+        its.it_value.tv_sec = (time_t)(deadline_uS / 1000000ULL);
+        its.it_value.tv_nsec = (long)((deadline_uS % 1000000ULL) * 1000ULL);
+        if(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) {
+            its.it_value.tv_nsec = 1;
+        }
+    }
+
+    timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+int isotp_socketcan_loop_run_once(isotp_socketcan_loop_t* loop, const int timeout_ms) {
+    //  Safety
+    if(loop == NULL || loop->epoll_fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    //  Pick up sends started outside the loop before sleeping
+    socketcan_loop_transmit(loop, isotp_socketcan_time_uS(NULL), isotp_timer_heap_next_deadline(loop->timer_heap));
+
+    //  Wait
+    struct epoll_event events[SOCKETCAN_LOOP_EVENTS];
+    int n = epoll_wait(loop->epoll_fd, events, SOCKETCAN_LOOP_EVENTS, timeout_ms);
+    if(n < 0) {
+        if(errno != EINTR) {
+            return -1;
+        }
+
+        n = 0;
+    }
+
+    //  Receive
+    for(int i = 0; i < n; i++) {
+        if(events[i].data.ptr == loop) {
+            //  Acknowledge timer expiry
+            uint64_t expirations;
+            ssize_t ret = read(loop->timer_fd, &expirations, sizeof(expirations));
+            (void)ret;
+            continue;
+        }
+
+        isotp_socketcan_t* iface = (isotp_socketcan_t*)events[i].data.ptr;
+        if(events[i].events & EPOLLIN) {
+            isotp_socketcan_receive(iface);
+        }
+
+        if(events[i].events & EPOLLOUT) {
+            socketcan_wait_writable(iface, false);
+        }
+    }
+
+    //  Timeouts
+    const uint64_t now_uS = isotp_socketcan_time_uS(NULL);
+    uint64_t deadline_uS = ISOTP_SESSION_DEADLINE_NONE;
+
+    if(loop->timer_heap != NULL) {
+        deadline_uS = isotp_timer_heap_tick(loop->timer_heap, now_uS);
+    }
+
+    //  Transmit (flow control answers to frames just received go out in the same pass)
+    socketcan_loop_transmit(loop, now_uS, deadline_uS);
+
+    return n;
+}
+
+void isotp_socketcan_loop_close(isotp_socketcan_loop_t* loop) {
+    //  Safety
+    if(loop == NULL) {
+        return;
+    }
+
+    if(loop->timer_fd >= 0) {
+        close(loop->timer_fd);
+        loop->timer_fd = -1;
+    }
+
+    if(loop->epoll_fd >= 0) {
+        close(loop->epoll_fd);
+        loop->epoll_fd = -1;
+    }
+
+    //  Detach interfaces
+    while(loop->interfaces != NULL) {
+        isotp_socketcan_t* iface = loop->interfaces;
+        loop->interfaces = iface->next;
+        iface->loop = NULL;
+        iface->next = NULL;
+    }
+}
+
+#endif
@@ -0,0 +1,174 @@
+#pragma once
+
+/*
+    ISO-TP SocketCAN Backend
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Linux only. Binds a CAN_RAW socket to an interface and moves frames between it and an `isotp_router_t`.
+    Kernel CAN_RAW filters are derived from the router's registered receive identifiers, frames are moved in
+    batches with recvmmsg/sendmmsg, and any number of interfaces can be driven from a single epoll loop that
+    uses a timerfd to wake for separation time (STmin) pacing and session timeouts.
+
+    Sessions must use `isotp_socketcan_time_uS` as their `callback_time_uS` for pacing to be honored.
+    This header is not part of `isotplib.h`, include it directly.
+*/
+
+#if defined(__linux__)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <linux/can.h>
+#include "isotp_router.h"
+#include "isotp_timer.h"
+
+//  Frames moved per recvmmsg/sendmmsg call
+#ifndef ISOTP_SOCKETCAN_BATCH_SIZE
+#define ISOTP_SOCKETCAN_BATCH_SIZE 32
+#endif
+
+//  Retry interval when the interface transmit queue is full (ENOBUFS)
+#ifndef ISOTP_SOCKETCAN_TX_RETRY_uS
+#define ISOTP_SOCKETCAN_TX_RETRY_uS 1000
+#endif
+
+struct isotp_socketcan_loop_s;
+
+//  SocketCAN interface
+typedef struct isotp_socketcan_s {
+	//	Configuration
+	int socket_fd;											//  CAN_RAW socket (-1 = closed)
+	isotp_router_t* router;									//  Router frames are dispatched through
+	bool fd_frames;											//  Transmit CAN FD frames (frame size 64) instead of classic frames (frame size 8)
+	uint8_t fd_flags;										//  (Config) Flags for transmitted CAN FD frames (ex: CANFD_BRS)
+	struct can_filter* filters;								//  User provided filter storage (NULL = no kernel filtering)
+	size_t filter_capacity;									//  Number of entries in `filters`
+
+	//	Event loop
+	struct isotp_socketcan_loop_s* loop;					//  (Live) Loop the interface is registered with
+	struct isotp_socketcan_s* next;							//  (Live) Next interface on the loop
+	bool tx_wait_writable;									//  (Live) Waiting for EPOLLOUT to send pending frames
+	uint64_t tx_retry_uS;									//  (Live) Time to retry pending frames after ENOBUFS (ISOTP_SESSION_DEADLINE_NONE = none)
+
+	//	Batches
+	size_t tx_pending_idx;									//  (Live) First pending frame in `tx_frames`
+	size_t tx_pending_count;								//  (Live) Number of frames in `tx_frames`
+	struct canfd_frame rx_frames[ISOTP_SOCKETCAN_BATCH_SIZE];	//  recvmmsg landing area
+	struct canfd_frame tx_frames[ISOTP_SOCKETCAN_BATCH_SIZE];	//  Frames taken from the router, not yet accepted by the socket
+} isotp_socketcan_t;
+
+//  Event loop driving one or more interfaces
+typedef struct isotp_socketcan_loop_s {
+	int epoll_fd;											//  epoll instance (-1 = closed)
+	int timer_fd;											//  timerfd armed for the next pacing or timeout deadline
+	isotp_socketcan_t* interfaces;							//  (Live) Registered interfaces
+	isotp_timer_heap_t* timer_heap;							//  (Optional) Timer heap ticked on every wakeup
+} isotp_socketcan_loop_t;
+
+/**
+ * @brief Monotonic clock for `callback_time_uS` (CLOCK_MONOTONIC, the clock the event loop sleeps on)
+ *
+ * @param context Unused
+ * @return uint64_t Current time in microseconds
+ */
+uint64_t isotp_socketcan_time_uS(void* context);
+
+/**
+ * @brief Opens a non-blocking CAN_RAW socket bound to `ifname` and applies filters for the router's sessions
+ *
+ * @param iface Interface to initialize
+ * @param ifname Interface name (ex: "can0", "vcan0")
+ * @param router Router frames are dispatched through
+ * @param fd_frames Enable CAN FD (the interface MTU must allow it)
+ * @param filters (Optional) Filter storage, at least as many entries as sessions registered with the router
+ * @param filter_capacity Number of entries in `filters`
+ * @return true Socket open
+ * @return false Socket could not be created, configured or bound (see errno)
+ */
+bool isotp_socketcan_open(isotp_socketcan_t* iface, const char* ifname, isotp_router_t* router, const bool fd_frames, struct can_filter* filters, const size_t filter_capacity);
+
+/**
+ * @brief Closes the socket (remove it from its loop first)
+ *
+ * @param iface Interface to close
+ */
+void isotp_socketcan_close(isotp_socketcan_t* iface);
+
+/**
+ * @brief Rebuilds the kernel CAN_RAW filters from the router's receive identifiers. Call after adding or removing sessions.
+ *
+ * @param iface Interface to update
+ * @return true Filters applied (no sessions = the kernel drops every frame)
+ * @return false Filter storage too small or setsockopt failed, kernel filtering disabled so no frames are lost
+ */
+bool isotp_socketcan_update_filters(isotp_socketcan_t* iface);
+
+/**
+ * @brief Reads every queued frame from the socket and dispatches it through the router
+ *
+ * @param iface Interface to read
+ * @return size_t Number of frames read
+ */
+size_t isotp_socketcan_receive(isotp_socketcan_t* iface);
+
+/**
+ * @brief Sends pending frames, then pulls and sends new frames from the router until nothing is due or the socket is full
+ *
+ * @param iface Interface to flush
+ * @return size_t Number of frames sent
+ */
+size_t isotp_socketcan_flush(isotp_socketcan_t* iface);
+
+/**
+ * @brief Creates the epoll instance and timerfd of an event loop
+ *
+ * @param loop Loop to initialize
+ * @param timer_heap (Optional) Timer heap to tick for session timeouts
+ * @return true Loop ready
+ * @return false epoll or timerfd creation failed (see errno)
+ */
+bool isotp_socketcan_loop_init(isotp_socketcan_loop_t* loop, isotp_timer_heap_t* timer_heap);
+
+/**
+ * @brief Registers an open interface with the loop
+ *
+ * @param loop Loop to register with
+ * @param iface Open interface
+ * @return true Interface registered
+ * @return false Invalid parameters or epoll_ctl failed
+ */
+bool isotp_socketcan_loop_add(isotp_socketcan_loop_t* loop, isotp_socketcan_t* iface);
+
+/**
+ * @brief Removes an interface from the loop
+ *
+ * @param loop Loop to update
+ * @param iface Registered interface
+ */
+void isotp_socketcan_loop_remove(isotp_socketcan_loop_t* loop, isotp_socketcan_t* iface);
+
+/**
+ * @brief Waits for socket or timer events, receives, ticks timeouts, transmits everything due and re-arms the timer. Call after starting a send from outside the loop so it is picked up immediately.
+ *
+ * @param loop Loop to run
+ * @param timeout_ms Maximum wait (-1 = until an event, 0 = do not block)
+ * @return int Number of events handled, -1 on error (see errno)
+ */
+int isotp_socketcan_loop_run_once(isotp_socketcan_loop_t* loop, const int timeout_ms);
+
+/**
+ * @brief Closes the epoll instance and timerfd (interfaces are left open)
+ *
+ * @param loop Loop to close
+ */
+void isotp_socketcan_loop_close(isotp_socketcan_loop_t* loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
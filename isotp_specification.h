@@ -26,6 +26,15 @@ typedef enum {
 	ISOTP_SPEC_FRAME_FLOW_CONTROL = 0x03
 } isotp_spec_frame_type_t;
 
+//  Address byte (extended & mixed addressing prefix every frame with N_TA / N_AE, all other indices shift by its length)
+#define ISOTP_SPEC_FRAME_ADDRESS_IDX 0
+#define ISOTP_SPEC_FRAME_ADDRESS_LEN 1
+
+//  CAN FD data length codes (up to 8 the DLC is the length, DLC 9-15 select 12, 16, 20, 24, 32, 48 and 64 bytes)
+#define ISOTP_SPEC_FD_DLC_CLASSIC_MAX 8
+#define ISOTP_SPEC_FD_DLC_MAX 15
+#define ISOTP_SPEC_FD_LEN_MAX 64
+
 //  All frames
 #define ISOTP_SPEC_FRAME_TYPE_IDX 0
 #define ISOTP_SPEC_FRAME_TYPE_MASK 0xF0
@@ -101,6 +110,11 @@ typedef enum {
 #define ISOTP_SPEC_FC_SEPERATION_TIME_uS_MAX 0xF9
 #define ISOTP_SPEC_FC_SEPERATION_TIME_uS_SCALAR 100
 
+//  Network layer timeouts (ISO 15765-2 defaults)
+#define ISOTP_SPEC_TIMEOUT_N_AS_DEFAULT_uS 1000000
+#define ISOTP_SPEC_TIMEOUT_N_BS_DEFAULT_uS 1000000
+#define ISOTP_SPEC_TIMEOUT_N_CR_DEFAULT_uS 1000000
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
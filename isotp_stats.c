@@ -0,0 +1,110 @@
+#include <string.h>
+#include "isotp_stats.h"
+
+//  Counters are a flat run of isotp_stat_t, so they can be summed as an array
+#define STATS_COUNTER_COUNT (sizeof(isotp_session_stats_t) / sizeof(isotp_stat_t))
+
+bool isotp_stats_enabled(void) {
+#ifdef ISOTP_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void isotp_stats_snapshot(const isotp_session_t* session, isotp_session_stats_t* stats) {
+    //  Safety
+    if(stats == NULL) {
+        return;
+    }
+
+#ifdef ISOTP_ENABLE_STATS
+    if(session != NULL) {
+        *stats = session->stats;
+        return;
+    }
+#else
+    (void)session;
+#endif
+
+    memset(stats, 0, sizeof(isotp_session_stats_t));
+}
+
+void isotp_stats_reset(isotp_session_t* session) {
+#ifdef ISOTP_ENABLE_STATS
+    if(session != NULL) {
+        memset(&session->stats, 0, sizeof(isotp_session_stats_t));
+    }
+#else
+    (void)session;
+#endif
+}
+
+void isotp_stats_accumulate(isotp_session_stats_t* total, const isotp_session_stats_t* stats) {
+    //  Safety
+    if(total == NULL || stats == NULL) {
+        return;
+    }
+
+    isotp_stat_t* dst = (isotp_stat_t*)total;
+    const isotp_stat_t* src = (const isotp_stat_t*)stats;
+    for(size_t i = 0; i < STATS_COUNTER_COUNT; i++) {
+        dst[i] += src[i];
+    }
+}
+
+void isotp_stats_aggregate(isotp_session_t* const* sessions, const size_t session_count, isotp_session_stats_t* total, const bool reset) {
+    //  Safety
+    if(total == NULL) {
+        return;
+    }
+
+    memset(total, 0, sizeof(isotp_session_stats_t));
+
+#ifdef ISOTP_ENABLE_STATS
+    if(sessions == NULL) {
+        return;
+    }
+
+    for(size_t i = 0; i < session_count; i++) {
+        if(sessions[i] == NULL) {
+            continue;
+        }
+
+        isotp_stats_accumulate(total, &sessions[i]->stats);
+        if(reset) { isotp_stats_reset(sessions[i]); }
+    }
+#else
+    (void)sessions;
+    (void)session_count;
+    (void)reset;
+#endif
+}
+
+void isotp_stats_aggregate_router(const isotp_router_t* router, isotp_session_stats_t* total, const bool reset) {
+    //  Safety
+    if(total == NULL) {
+        return;
+    }
+
+    memset(total, 0, sizeof(isotp_session_stats_t));
+
+#ifdef ISOTP_ENABLE_STATS
+    if(router == NULL || router->entries == NULL) {
+        return;
+    }
+
+    for(size_t idx = 0; idx < router->capacity; idx++) {
+        isotp_session_t* session = router->entries[idx].session;
+        if(session == NULL) {
+            continue;
+        }
+
+        isotp_stats_accumulate(total, &session->stats);
+        if(reset) { isotp_stats_reset(session); }
+    }
+#else
+    (void)router;
+    (void)reset;
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+    ISO-TP Session Statistics
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Optional counters maintained directly in the session hot paths (frames by type, payload bytes, completed
+    transfers, flow control WAIT/overflow and error aborts). Build every translation unit with ISOTP_ENABLE_STATS
+    to enable them, otherwise the counters and their updates compile out entirely and the snapshot functions
+    report zeros.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+#include "isotp_router.h"
+
+//  Counter updates used by the session hot paths
+#ifdef ISOTP_ENABLE_STATS
+#define ISOTP_STATS_ADD(session, counter, amount) ((session)->stats.counter += (isotp_stat_t)(amount))
+#else
+//  Only named in sizeof, never evaluated
+#define ISOTP_STATS_ADD(session, counter, amount) ((void)sizeof(session), (void)sizeof(amount))
+#endif
+
+#define ISOTP_STATS_INC(session, counter) ISOTP_STATS_ADD(session, counter, 1)
+
+/**
+ * @brief Whether the library was built with ISOTP_ENABLE_STATS
+ *
+ * @return true Counters are maintained
+ * @return false Counters are compiled out
+ */
+bool isotp_stats_enabled(void);
+
+/**
+ * @brief Copies a session's counters
+ *
+ * @param session Session to read
+ * @param stats Outputted counters (zeroed if statistics are disabled)
+ */
+void isotp_stats_snapshot(const isotp_session_t* session, isotp_session_stats_t* stats);
+
+/**
+ * @brief Clears a session's counters
+ *
+ * @param session Session to reset
+ */
+void isotp_stats_reset(isotp_session_t* session);
+
+/**
+ * @brief Adds every counter of `stats` to `total`
+ *
+ * @param total Running totals
+ * @param stats Counters to add
+ */
+void isotp_stats_accumulate(isotp_session_stats_t* total, const isotp_session_stats_t* stats);
+
+/**
+ * @brief Sums the counters of many sessions, optionally clearing them so consecutive calls return deltas for exporting
+ *
+ * @param sessions Sessions to aggregate (NULL entries are skipped)
+ * @param session_count Number of sessions
+ * @param total Outputted totals
+ * @param reset Clear each session's counters after reading
+ */
+void isotp_stats_aggregate(isotp_session_t* const* sessions, const size_t session_count, isotp_session_stats_t* total, const bool reset);
+
+/**
+ * @brief Sums the counters of every session registered with a router (see `isotp_stats_aggregate`)
+ *
+ * @param router Router to aggregate
+ * @param total Outputted totals
+ * @param reset Clear each session's counters after reading
+ */
+void isotp_stats_aggregate_router(const isotp_router_t* router, isotp_session_stats_t* total, const bool reset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,173 @@
+#include "isotp_timer.h"
+
+//  Heap index of sessions without an armed timer
+#define TIMER_HEAP_IDX_NONE SIZE_MAX
+
+//  Place session at idx and record its position
+static inline void heap_place(isotp_timer_heap_t* heap, size_t idx, isotp_session_t* session) {
+    heap->sessions[idx] = session;
+    session->timer_heap_idx = idx;
+}
+
+static void heap_sift_up(isotp_timer_heap_t* heap, size_t idx) {
+    isotp_session_t* session = heap->sessions[idx];
+
+    while(idx > 0) {
+        size_t parent = (idx - 1) / 2;
+        if(heap->sessions[parent]->deadline_uS <= session->deadline_uS) {
+            break;
+        }
+
+        heap_place(heap, idx, heap->sessions[parent]);
+        idx = parent;
+    }
+
+    heap_place(heap, idx, session);
+}
+
+static void heap_sift_down(isotp_timer_heap_t* heap, size_t idx) {
+    isotp_session_t* session = heap->sessions[idx];
+
+    while(true) {
+        size_t child = idx * 2 + 1;
+        if(child >= heap->count) {
+            break;
+        }
+
+        //  Pick earlier child
+        if(child + 1 < heap->count && heap->sessions[child + 1]->deadline_uS < heap->sessions[child]->deadline_uS) {
+            child++;
+        }
+
+        if(session->deadline_uS <= heap->sessions[child]->deadline_uS) {
+            break;
+        }
+
+        heap_place(heap, idx, heap->sessions[child]);
+        idx = child;
+    }
+
+    heap_place(heap, idx, session);
+}
+
+static void heap_remove(isotp_timer_heap_t* heap, isotp_session_t* session) {
+    size_t idx = session->timer_heap_idx;
+    session->timer_heap_idx = TIMER_HEAP_IDX_NONE;
+
+    //  Move last entry into the gap
+    heap->count--;
+    if(idx == heap->count) {
+        return;
+    }
+
+    isotp_session_t* moved = heap->sessions[heap->count];
+    heap_place(heap, idx, moved);
+    heap_sift_up(heap, idx);
+    heap_sift_down(heap, moved->timer_heap_idx);
+}
+
+bool isotp_timer_heap_init(isotp_timer_heap_t* heap, isotp_session_t** sessions, size_t capacity) {
+    //  Safety
+    if(heap == NULL || sessions == NULL || capacity == 0) {
+        return false;
+    }
+
+    heap->sessions = sessions;
+    heap->capacity = capacity;
+    heap->count = 0;
+    heap->attached = 0;
+
+    return true;
+}
+
+bool isotp_timer_heap_attach(isotp_timer_heap_t* heap, isotp_session_t* session) {
+    //  Safety
+    if(heap == NULL || session == NULL || session->timer_heap != NULL) {
+        return false;
+    }
+
+    //  Every attached session must fit even if all are armed
+    if(heap->attached >= heap->capacity) {
+        return false;
+    }
+
+    heap->attached++;
+    session->timer_heap = heap;
+    session->timer_heap_idx = TIMER_HEAP_IDX_NONE;
+
+    //  Track current deadline
+    isotp_timer_heap_update(heap, session);
+    return true;
+}
+
+void isotp_timer_heap_detach(isotp_timer_heap_t* heap, isotp_session_t* session) {
+    //  Safety
+    if(heap == NULL || session == NULL || session->timer_heap != heap) {
+        return;
+    }
+
+    if(session->timer_heap_idx != TIMER_HEAP_IDX_NONE) {
+        heap_remove(heap, session);
+    }
+
+    heap->attached--;
+    session->timer_heap = NULL;
+}
+
+void isotp_timer_heap_update(isotp_timer_heap_t* heap, isotp_session_t* session) {
+    //  Safety
+    if(heap == NULL || session == NULL) {
+        return;
+    }
+
+    const bool armed = session->deadline_uS != ISOTP_SESSION_DEADLINE_NONE;
+
+    //  Not in heap
+    if(session->timer_heap_idx == TIMER_HEAP_IDX_NONE) {
+        if(armed) {
+            heap_place(heap, heap->count, session);
+            heap->count++;
+            heap_sift_up(heap, session->timer_heap_idx);
+        }
+        return;
+    }
+
+    //  Disarmed
+    if(!armed) {
+        heap_remove(heap, session);
+        return;
+    }
+
+    //  Deadline moved
+    heap_sift_up(heap, session->timer_heap_idx);
+    heap_sift_down(heap, session->timer_heap_idx);
+}
+
+uint64_t isotp_timer_heap_tick(isotp_timer_heap_t* heap, const uint64_t now_uS) {
+    //  Safety
+    if(heap == NULL) {
+        return ISOTP_SESSION_DEADLINE_NONE;
+    }
+
+    //  Expire from the top, each session expires at most once per tick
+    for(size_t expired = 0; expired < heap->attached && heap->count > 0; expired++) {
+        isotp_session_t* session = heap->sessions[0];
+        if(session->deadline_uS > now_uS) {
+            break;
+        }
+
+        //  Disarms (removing it from the heap) and runs the timeout callback
+        isotp_session_tick(session, now_uS);
+    }
+
+    return isotp_timer_heap_next_deadline(heap);
+}
+
+uint64_t isotp_timer_heap_next_deadline(const isotp_timer_heap_t* heap) {
+    //  Safety
+    if(heap == NULL || heap->count == 0) {
+        return ISOTP_SESSION_DEADLINE_NONE;
+    }
+
+    return heap->sessions[0]->deadline_uS;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+    ISO-TP Timer Heap
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Tracks the N_As/N_Bs/N_Cr deadlines of many sessions in a binary min-heap, so expiring timers costs
+    O(expired * log n) instead of a sweep over every session. Sessions keep the heap ordered themselves
+    whenever they arm or disarm a timer, and the heap never allocates memory.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+
+//  Timer heap
+typedef struct isotp_timer_heap_s {
+	isotp_session_t** sessions;				//  User provided storage, one slot per attached session
+	size_t capacity;						//  Number of slots in `sessions`
+	size_t count;							//  (Live) Sessions with an armed timer (heap size)
+	size_t attached;						//  (Live) Sessions attached to the heap
+} isotp_timer_heap_t;
+
+/**
+ * @brief Initializes a timer heap over user provided storage
+ *
+ * @param heap Heap to initialize
+ * @param sessions Slot storage
+ * @param capacity Number of slots, the maximum number of sessions that can be attached
+ * @return true Heap initialized
+ * @return false Invalid parameters
+ */
+bool isotp_timer_heap_init(isotp_timer_heap_t* heap, isotp_session_t** sessions, size_t capacity);
+
+/**
+ * @brief Attaches a session so its deadlines are tracked by the heap
+ *
+ * @param heap Heap to attach to
+ * @param session Session to track
+ * @return true Session attached
+ * @return false Heap full or session already attached to a heap
+ */
+bool isotp_timer_heap_attach(isotp_timer_heap_t* heap, isotp_session_t* session);
+
+/**
+ * @brief Detaches a session from the heap
+ *
+ * @param heap Heap the session is attached to
+ * @param session Session to stop tracking
+ */
+void isotp_timer_heap_detach(isotp_timer_heap_t* heap, isotp_session_t* session);
+
+/**
+ * @brief Re-positions a session after its deadline changed. Called by the session itself, users do not need to call this.
+ *
+ * @param heap Heap the session is attached to
+ * @param session Session whose deadline changed
+ */
+void isotp_timer_heap_update(isotp_timer_heap_t* heap, isotp_session_t* session);
+
+/**
+ * @brief Expires every session whose deadline has passed (see `isotp_session_tick`)
+ *
+ * @param heap Heap to process
+ * @param now_uS Current time from the sessions' clock
+ * @return uint64_t Earliest remaining deadline (ISOTP_SESSION_DEADLINE_NONE = no timer armed)
+ */
+uint64_t isotp_timer_heap_tick(isotp_timer_heap_t* heap, const uint64_t now_uS);
+
+/**
+ * @brief Earliest deadline of all attached sessions
+ *
+ * @param heap Heap to query
+ * @return uint64_t Earliest deadline (ISOTP_SESSION_DEADLINE_NONE = no timer armed)
+ */
+uint64_t isotp_timer_heap_next_deadline(const isotp_timer_heap_t* heap);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+#include <string.h>
+#include "isotp_trace.h"
+
+bool isotp_trace_init(isotp_trace_ring_t* ring, isotp_trace_event_t* events, const size_t capacity, uint64_t (*callback_time_uS)(void* context), void* time_context) {
+    //  Safety (capacity must be a power of two so indices can be masked)
+    if(ring == NULL || events == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    memset(ring, 0, sizeof(isotp_trace_ring_t));
+    ring->events = events;
+    ring->mask = capacity - 1;
+    ring->callback_time_uS = callback_time_uS;
+    ring->time_context = time_context;
+
+    return true;
+}
+
+bool isotp_trace_attach(isotp_trace_ring_t* ring, isotp_session_t* session, const uint16_t session_id) {
+    //  Safety
+    if(session == NULL) {
+        return false;
+    }
+
+#ifdef ISOTP_ENABLE_TRACE
+    session->trace = ring;
+    session->trace_id = session_id;
+    return true;
+#else
+    (void)ring;
+    (void)session_id;
+    return false;
+#endif
+}
+
+void isotp_trace_record(isotp_trace_ring_t* ring, const uint16_t session_id, const uint8_t type, const uint8_t arg, const uint8_t* data, const size_t length) {
+    //  Only the producer writes head, the consumer publishes tail
+    const size_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    //  Full, drop rather than block
+    if(head - tail > ring->mask) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    //  Fill slot
+    isotp_trace_event_t* event = &ring->events[head & ring->mask];
+    event->timestamp_uS = (ring->callback_time_uS != NULL) ? (uint32_t)ring->callback_time_uS(ring->time_context) : 0;
+    event->session_id = session_id;
+    event->type = type;
+    event->arg = arg;
+
+    const size_t copy_len = (data == NULL) ? 0 : (length < sizeof(event->data)) ? length : sizeof(event->data);
+    if(copy_len > 0) { memcpy(event->data, data, copy_len); }
+    memset(event->data + copy_len, 0, sizeof(event->data) - copy_len);
+
+    //  Publish
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void isotp_trace_state(isotp_session_t* session, const isotp_session_state_t new_state) {
+#ifdef ISOTP_ENABLE_TRACE
+    const uint8_t previous = (uint8_t)session->state;
+    isotp_trace_record(session->trace, session->trace_id, ISOTP_TRACE_STATE, (uint8_t)new_state, &previous, 1);
+#else
+    (void)session;
+    (void)new_state;
+#endif
+}
+
+void isotp_trace_flow_control(isotp_session_t* session, const isotp_trace_event_type_t type, const uint8_t flag, const uint8_t block_size, const uint32_t separation_uS) {
+#ifdef ISOTP_ENABLE_TRACE
+    const uint8_t data[5] = {
+        block_size,
+        (uint8_t)separation_uS, (uint8_t)(separation_uS >> 8), (uint8_t)(separation_uS >> 16), (uint8_t)(separation_uS >> 24)
+    };
+    isotp_trace_record(session->trace, session->trace_id, (uint8_t)type, flag, data, sizeof(data));
+#else
+    (void)session;
+    (void)type;
+    (void)flag;
+    (void)block_size;
+    (void)separation_uS;
+#endif
+}
+
+void isotp_trace_value(isotp_session_t* session, const isotp_trace_event_type_t type, const uint8_t arg, const size_t value) {
+#ifdef ISOTP_ENABLE_TRACE
+    const uint32_t saturated = (value > UINT32_MAX) ? UINT32_MAX : (uint32_t)value;
+    const uint8_t data[4] = { (uint8_t)saturated, (uint8_t)(saturated >> 8), (uint8_t)(saturated >> 16), (uint8_t)(saturated >> 24) };
+    isotp_trace_record(session->trace, session->trace_id, (uint8_t)type, arg, data, sizeof(data));
+#else
+    (void)session;
+    (void)type;
+    (void)arg;
+    (void)value;
+#endif
+}
+
+size_t isotp_trace_drain(isotp_trace_ring_t* ring, isotp_trace_event_t* events, const size_t max_events) {
+    //  Safety
+    if(ring == NULL || events == NULL) {
+        return 0;
+    }
+
+    const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    const size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    size_t count = head - tail;
+    if(count > max_events) {
+        count = max_events;
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        events[i] = ring->events[(tail + i) & ring->mask];
+    }
+
+    //  Hand the slots back to the producer
+    __atomic_store_n(&ring->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+uint32_t isotp_trace_dropped(const isotp_trace_ring_t* ring) {
+    //  Safety
+    if(ring == NULL) {
+        return 0;
+    }
+
+    return __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+/*
+    ISO-TP Trace Ring
+    ISOTPlib - ISO-TP Library for embedded systems
+
+    Fixed size, single producer / single consumer lock-free ring of compact binary events (frames in and out,
+    flow control parameters, state transitions and errors), each stamped with a time and a session id.
+    The sessions recording to a ring are the producer and must all run in one thread or interrupt context.
+    Any other core or thread may drain the ring concurrently, and events are dropped (and counted) when it is full,
+    so recording never blocks.
+
+    Build every translation unit with ISOTP_ENABLE_TRACE to enable recording, otherwise the session hooks compile
+    out entirely. `examples/trace-decoder` turns a dump of drained events into a text timeline.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "isotp_session.h"
+
+//  Spacing between the producer and consumer indices, so draining from another core does not slow down recording
+#ifndef ISOTP_TRACE_CACHE_LINE
+#define ISOTP_TRACE_CACHE_LINE 64
+#endif
+
+//  Trace event types
+typedef enum {
+	ISOTP_TRACE_FRAME_RX = 0,				//  Frame recieved: arg = length, data = first 8 bytes
+	ISOTP_TRACE_FRAME_TX = 1,				//  Frame transmitted: arg = length, data = first 8 bytes
+	ISOTP_TRACE_FC_RX = 2,					//  Flow control recieved: arg = flag, data[0] = block size, data[1..4] = separation uS (little endian)
+	ISOTP_TRACE_FC_TX = 3,					//  Flow control transmitted: same layout as ISOTP_TRACE_FC_RX
+	ISOTP_TRACE_STATE = 4,					//  State transition: arg = new state, data[0] = previous state
+	ISOTP_TRACE_ERROR = 5,					//  Error: arg = isotp_trace_error_t, data = error specific (see below)
+} isotp_trace_event_type_t;
+
+//  Errors recorded with ISOTP_TRACE_ERROR
+typedef enum {
+	ISOTP_TRACE_ERROR_INVALID_FRAME = 0,		//  data = first 8 bytes of the frame
+	ISOTP_TRACE_ERROR_UNEXPECTED_FRAME = 1,		//  data = first 8 bytes of the frame
+	ISOTP_TRACE_ERROR_OUT_OF_ORDER = 2,			//  data[0] = expected index, data[1] = recieved index
+	ISOTP_TRACE_ERROR_TOO_LARGE = 3,			//  data[0..3] = announced transmission length (little endian, saturated)
+	ISOTP_TRACE_ERROR_PARTNER_ABORTED = 4,		//  data = first 8 bytes of the frame
+	ISOTP_TRACE_ERROR_TIMEOUT = 5,				//  data[0] = isotp_session_timer_t
+	ISOTP_TRACE_ERROR_FC_OVERFLOW = 6,			//  Reception abandoned with an FC overflow (N_WFTmax reached or policy abort)
+	ISOTP_TRACE_ERROR_RX_BUSY = 7,				//  data = first 8 bytes of the frame starting the dropped message
+} isotp_trace_error_t;
+
+//  Trace event (16 bytes, dumps are a plain array of these in the producer's byte order)
+typedef struct {
+	uint32_t timestamp_uS;					//  Clock at record time, truncated to 32 bits (wraps every ~71 minutes)
+	uint16_t session_id;					//  `trace_id` of the recording session
+	uint8_t type;							//  isotp_trace_event_type_t
+	uint8_t arg;							//  Event specific
+	uint8_t data[8];						//  Event specific
+} isotp_trace_event_t;
+
+//  Trace ring
+typedef struct isotp_trace_ring_s {
+	//	Configuration
+	isotp_trace_event_t* events;			//  User provided storage
+	size_t mask;							//  Capacity - 1 (capacity is a power of two)
+	uint64_t (*callback_time_uS)(void* context);	//  (Optional) Clock for timestamps (NULL = 0)
+	void* time_context;						//  Context passed to `callback_time_uS`
+
+	//	Producer
+	uint8_t pad_producer[ISOTP_TRACE_CACHE_LINE];
+	size_t head;							//  (Live) Events recorded
+	uint32_t dropped;						//  (Live) Events dropped because the ring was full
+
+	//	Consumer
+	uint8_t pad_consumer[ISOTP_TRACE_CACHE_LINE];
+	size_t tail;							//  (Live) Events drained
+} isotp_trace_ring_t;
+
+//  Event recording used by the session hot paths
+#ifdef ISOTP_ENABLE_TRACE
+#define ISOTP_TRACE(session, type, arg, data, length) \
+	(((session)->trace != NULL) ? isotp_trace_record((session)->trace, (session)->trace_id, (type), (uint8_t)(arg), (const uint8_t*)(data), (length)) : (void)0)
+#define ISOTP_TRACE_STATE(session, new_state) \
+	(((session)->trace != NULL && (session)->state != (new_state)) ? isotp_trace_state((session), (new_state)) : (void)0)
+#define ISOTP_TRACE_FC(session, type, flag, block_size, separation_uS) \
+	(((session)->trace != NULL) ? isotp_trace_flow_control((session), (type), (uint8_t)(flag), (uint8_t)(block_size), (separation_uS)) : (void)0)
+#define ISOTP_TRACE_VALUE(session, type, arg, value) \
+	(((session)->trace != NULL) ? isotp_trace_value((session), (type), (uint8_t)(arg), (value)) : (void)0)
+#else
+//  Arguments are referenced but not evaluated, so variables only passed here do not trigger unused warnings
+#define ISOTP_TRACE(session, type, arg, data, length) \
+	((void)sizeof(session), (void)sizeof(type), (void)sizeof(arg), (void)sizeof(data), (void)sizeof(length))
+#define ISOTP_TRACE_STATE(session, new_state) ((void)sizeof(session), (void)sizeof(new_state))
+#define ISOTP_TRACE_FC(session, type, flag, block_size, separation_uS) \
+	((void)sizeof(session), (void)sizeof(type), (void)sizeof(flag), (void)sizeof(block_size), (void)sizeof(separation_uS))
+#define ISOTP_TRACE_VALUE(session, type, arg, value) ((void)sizeof(session), (void)sizeof(type), (void)sizeof(arg), (void)sizeof(value))
+#endif
+
+#define ISOTP_TRACE_ERROR(session, error, data, length) ISOTP_TRACE(session, ISOTP_TRACE_ERROR, error, data, length)
+
+/**
+ * @brief Initializes a trace ring over user provided storage
+ *
+ * @param ring Ring to initialize
+ * @param events Event storage
+ * @param capacity Number of events in `events`, must be a power of two
+ * @param callback_time_uS (Optional) Clock for timestamps, the same one the sessions use is a good choice
+ * @param time_context Context passed to `callback_time_uS`
+ * @return true Ring initialized
+ * @return false Invalid parameters
+ */
+bool isotp_trace_init(isotp_trace_ring_t* ring, isotp_trace_event_t* events, const size_t capacity, uint64_t (*callback_time_uS)(void* context), void* time_context);
+
+/**
+ * @brief Makes a session record its events to a ring (call after `isotp_session_init`)
+ *
+ * @param ring Ring to record to (NULL = stop recording)
+ * @param session Session to trace
+ * @param session_id Id recorded with the session's events
+ * @return true Session attached
+ * @return false Invalid parameters or library built without ISOTP_ENABLE_TRACE
+ */
+bool isotp_trace_attach(isotp_trace_ring_t* ring, isotp_session_t* session, const uint16_t session_id);
+
+/**
+ * @brief Records an event (producer side, never blocks)
+ *
+ * @param ring Ring to record to
+ * @param session_id Session id
+ * @param type isotp_trace_event_type_t
+ * @param arg Event specific
+ * @param data (Optional) Event data, only the first 8 bytes are kept
+ * @param length Length of `data`
+ */
+void isotp_trace_record(isotp_trace_ring_t* ring, const uint16_t session_id, const uint8_t type, const uint8_t arg, const uint8_t* data, const size_t length);
+
+/**
+ * @brief Records a session state transition (used by ISOTP_TRACE_STATE)
+ *
+ * @param session Session about to change state
+ * @param new_state State being entered
+ */
+void isotp_trace_state(isotp_session_t* session, const isotp_session_state_t new_state);
+
+/**
+ * @brief Records flow control parameters
+ *
+ * @param session Session sending or recieving the flow control
+ * @param type ISOTP_TRACE_FC_RX or ISOTP_TRACE_FC_TX
+ * @param flag Flow control flag
+ * @param block_size Block size
+ * @param separation_uS Separation time in microseconds
+ */
+void isotp_trace_flow_control(isotp_session_t* session, const isotp_trace_event_type_t type, const uint8_t flag, const uint8_t block_size, const uint32_t separation_uS);
+
+/**
+ * @brief Records an event carrying a single value in data[0..3] (little endian, saturated to 32 bits)
+ *
+ * @param session Recording session
+ * @param type isotp_trace_event_type_t
+ * @param arg Event specific
+ * @param value Value to record
+ */
+void isotp_trace_value(isotp_session_t* session, const isotp_trace_event_type_t type, const uint8_t arg, const size_t value);
+
+/**
+ * @brief Moves recorded events out of the ring (consumer side, may run on another core or thread)
+ *
+ * @param ring Ring to drain
+ * @param events Outputted events, oldest first
+ * @param max_events Capacity of `events`
+ * @return size_t Number of events drained
+ */
+size_t isotp_trace_drain(isotp_trace_ring_t* ring, isotp_trace_event_t* events, const size_t max_events);
+
+/**
+ * @brief Number of events dropped because the ring was full
+ *
+ * @param ring Ring to read
+ * @return uint32_t Dropped events since init
+ */
+uint32_t isotp_trace_dropped(const isotp_trace_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,11 +5,26 @@
 // Include the C headers wrapped in `extern "C"` to prevent C++ name mangling
 extern "C" {
     #include "isotp_session.h"
+    #include "isotp_router.h"
+    #include "isotp_timer.h"
+    #include "isotp_stats.h"
+    #include "isotp_trace.h"
+    #include "isotp_frame_queue.h"
+    #include "isotp_pool.h"
+    #include "isotp_bustime.h"
     #include "isotp_conversions.h"
     #include "isotp_specification.h"
     #include "isotplib.h"
 }
 
+// C++ specializations
+#include "isotp_session_fixed.hpp"
+
+// C++20 typed sessions
+#if __cplusplus >= 202002L
+#include "isotp_session.hpp"
+#endif
+
 #else
 // If this file is included in a C environment, raise a compilation error
 #error "isotplib.cpp is designed to work in C++ environments only."
@@ -5,6 +5,13 @@ extern "C" {
 #endif
 
 #include "isotp_session.h"
+#include "isotp_router.h"
+#include "isotp_timer.h"
+#include "isotp_stats.h"
+#include "isotp_trace.h"
+#include "isotp_frame_queue.h"
+#include "isotp_pool.h"
+#include "isotp_bustime.h"
 
 #define ISOTPLIB_VERSION_MAJOR         1
 #define ISOTPLIB_VERSION_MINOR         1
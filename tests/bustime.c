@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <isotplib.h>
+
+/*
+    Bus time model against the loopback
+
+    `isotp_bustime_estimate` lays out frames as `isotp_session_can_tx` builds them. For every payload, format,
+    addressing mode, padding, TX_DL planning and block size, an in-memory sender/receiver pair moves the message and
+    its data frame count, flow control frame count and bytes on the wire must match the estimate exactly.
+    Timing is not checked, a loopback has none.
+    Exits with 1 on failure.
+*/
+
+static const size_t payload_sizes[] = { 1, 6, 7, 8, 62, 63, 64, 256, 1024, 4094, 4095, 4096, 65536 };
+static const size_t block_sizes[] = { 0, 8 };
+
+//  Loopback state
+static bool rx_complete = false;
+static size_t loop_data_frames = 0;
+static size_t loop_fc_frames = 0;
+static size_t loop_bytes = 0;
+
+static void cb_transmission_rx(void* context) {
+    rx_complete = true;
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static void cb_error(void* context, const uint8_t* data, const size_t length) {
+    (void)data;
+    (void)length;
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static bool check(const bool condition, const char* what, const isotp_session_protocol_config_t* config, const size_t frame_size, const size_t payload) {
+    if(!condition) {
+        printf("[FAIL] %s (%s, frame size %zu, addressing %d, padding %d, planned %d, block size %zu, %zu bytes)\n", what,
+               (config->frame_format == ISOTP_FORMAT_FD) ? "FD" : "NORMAL", frame_size, (int)config->addressing_mode,
+               (int)config->padding_enabled, (int)config->fd_tx_dl_planned, config->fc_default_request_size, payload);
+    }
+
+    return condition;
+}
+
+static void setup_session(isotp_session_t* session, const isotp_session_protocol_config_t* config, uint8_t* tx_buffer, size_t tx_len, uint8_t* rx_buffer, size_t rx_len) {
+    isotp_session_init(session, config->frame_format, tx_buffer, tx_len, rx_buffer, rx_len);
+    session->protocol_config = *config;
+    session->callback_transmission_rx = cb_transmission_rx;
+    session->callback_error_partner_aborted_transfer = cb_error;
+    session->callback_error_unexpected_frame_type = cb_error;
+    isotp_session_idle(session);
+}
+
+//  Moves one message through a loopback pair, counting frames and padded bytes (false = stalled)
+static bool run_loopback(const isotp_session_protocol_config_t* config, const size_t frame_size, uint8_t* data, uint8_t* rx_buffer, const size_t payload) {
+    isotp_session_t sender, receiver;
+    uint8_t frame[ISOTP_CAN_FRAME_MAX_SIZE];
+
+    setup_session(&sender, config, data, payload, NULL, 0);
+    setup_session(&receiver, config, NULL, 0, rx_buffer, payload);
+
+    rx_complete = false;
+    loop_data_frames = 0;
+    loop_fc_frames = 0;
+    loop_bytes = 0;
+    if(isotp_session_send(&sender, data, payload) == 0) {
+        return false;
+    }
+
+    while(!rx_complete) {
+        size_t moved = 0;
+
+        size_t len = isotp_session_can_tx(&sender, frame, frame_size, NULL);
+        if(len > 0) { isotp_session_can_rx(&receiver, frame, len); loop_data_frames++; loop_bytes += len; moved++; }
+
+        len = isotp_session_can_tx(&receiver, frame, frame_size, NULL);
+        if(len > 0) { isotp_session_can_rx(&sender, frame, len); loop_fc_frames++; loop_bytes += len; moved++; }
+
+        //  Stalled
+        if(moved == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool check_payloads(const isotp_bustime_link_t* link, const isotp_session_protocol_config_t* config, uint8_t* data, uint8_t* rx_buffer) {
+    bool ok = true;
+    for(size_t p = 0; p < sizeof(payload_sizes) / sizeof(payload_sizes[0]); p++) {
+        const size_t payload = payload_sizes[p];
+
+        //  Past the 12 bit first frame length, classic CAN cannot carry the message
+        isotp_bustime_estimate_t estimate;
+        if(!isotp_bustime_estimate(link, config, payload, &estimate)) {
+            ok &= check(config->frame_format != ISOTP_FORMAT_FD && payload > ISOTP_SPEC_FRAME_FIRST_FD_ENABLE_LEN, "estimate available", config, link->frame_size, payload);
+            continue;
+        }
+
+        if(!check(run_loopback(config, link->frame_size, data, rx_buffer, payload), "loopback completed", config, link->frame_size, payload)) {
+            ok = false;
+            continue;
+        }
+
+        ok &= check(loop_data_frames == estimate.data_frames, "data frames match", config, link->frame_size, payload);
+        ok &= check(loop_fc_frames == estimate.fc_frames, "flow control frames match", config, link->frame_size, payload);
+        ok &= check(loop_bytes == estimate.bytes_on_wire, "bytes on the wire match", config, link->frame_size, payload);
+    }
+
+    return ok;
+}
+
+int main(void) {
+    const size_t max_payload = payload_sizes[sizeof(payload_sizes) / sizeof(payload_sizes[0]) - 1];
+    uint8_t* data = calloc(max_payload, 1);
+    uint8_t* rx_buffer = malloc(max_payload);
+    if(data == NULL || rx_buffer == NULL) {
+        printf("[FAIL] bustime: out of memory\n");
+        return 1;
+    }
+
+    isotp_bustime_link_t link = { 0 };
+    link.nominal_bitrate = 500000;
+    link.data_bitrate = 2000000;
+    link.response_uS = 100;
+
+    isotp_session_t defaults;
+    isotp_session_init(&defaults, ISOTP_FORMAT_FD, NULL, 0, NULL, 0);
+
+    bool ok = true;
+    for(int variant = 0; variant < 3 * 3 * 2 * 2 * 2; variant++) {
+        isotp_session_protocol_config_t config = defaults.protocol_config;
+        int v = variant;
+
+        //  Classic CAN, CAN FD with 64 and 32 byte frames
+        const int format = v % 3; v /= 3;
+        config.frame_format = (format == 0) ? ISOTP_FORMAT_NORMAL : ISOTP_FORMAT_FD;
+        link.frame_size = (format == 0) ? 8 : (format == 1) ? ISOTP_CAN_FRAME_MAX_SIZE : 32;
+
+        config.addressing_mode = (v % 3 == 0) ? ISOTP_ADDRESSING_NORMAL : (v % 3 == 1) ? ISOTP_ADDRESSING_EXTENDED : ISOTP_ADDRESSING_MIXED; v /= 3;
+        config.padding_enabled = (v % 2) != 0; v /= 2;
+        config.fd_tx_dl_planned = (v % 2) != 0; v /= 2;
+        config.fc_default_request_size = block_sizes[v % 2];
+
+        //  Planning only applies to CAN FD
+        if(config.fd_tx_dl_planned && config.frame_format != ISOTP_FORMAT_FD) {
+            continue;
+        }
+
+        ok &= check_payloads(&link, &config, data, rx_buffer);
+    }
+
+    free(data);
+    free(rx_buffer);
+
+    printf("%s\n", ok ? "[PASS] bustime" : "[FAIL] bustime");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <isotplib.h>
+
+/*
+    Flow control policy without a clock
+
+    A receiver whose `callback_fc_policy` requests FC WAIT, but which has no `callback_time_uS` to pace WAIT frames
+    with, must hold flow control instead of sending WAITs back-to-back (which would hit `fc_wait_max` and abort the
+    transfer within microseconds). Once the policy stops waiting, the transfer completes.
+    Exits with 1 on failure.
+*/
+
+#define PAYLOAD_SIZE 200
+#define POLICY_WAITS 20
+
+static int waits_requested = 0;
+static bool rx_complete = false;
+
+static void cb_fc_policy(void* context, isotp_fc_policy_t* policy) {
+    (void)context;
+
+    //  Backpressure for the first calls
+    if(waits_requested < POLICY_WAITS) {
+        waits_requested++;
+        policy->flag = ISOTP_SPEC_FC_FLAG_WAIT;
+    }
+}
+
+static void cb_transmission_rx(void* context) {
+    (void)context;
+    rx_complete = true;
+}
+
+static void cb_error(void* context, const uint8_t* data, const size_t length) {
+    (void)data;
+    (void)length;
+    isotp_session_idle((isotp_session_t*)context);
+}
+
+static bool check(const bool condition, const char* what) {
+    if(!condition) {
+        printf("[FAIL] %s\n", what);
+    }
+
+    return condition;
+}
+
+int main(void) {
+    static uint8_t payload[PAYLOAD_SIZE];
+    static uint8_t rx_buffer[PAYLOAD_SIZE];
+    for(size_t i = 0; i < PAYLOAD_SIZE; i++) {
+        payload[i] = (uint8_t)i;
+    }
+
+    isotp_session_t sender, receiver;
+    isotp_session_init(&sender, ISOTP_FORMAT_NORMAL, NULL, 0, NULL, 0);
+    isotp_session_init(&receiver, ISOTP_FORMAT_NORMAL, NULL, 0, rx_buffer, sizeof(rx_buffer));
+    sender.callback_error_partner_aborted_transfer = cb_error;
+    receiver.callback_transmission_rx = cb_transmission_rx;
+    receiver.callback_fc_policy = cb_fc_policy;
+    receiver.protocol_config.fc_wait_max = 2;
+
+    bool ok = check(isotp_session_send_borrowed(&sender, payload, PAYLOAD_SIZE) == PAYLOAD_SIZE, "send started");
+
+    //  Loopback, counting flow control frames by flag
+    uint8_t frame[8];
+    size_t fc_wait_frames = 0;
+    size_t fc_overflow_frames = 0;
+    for(int step = 0; step < 1000 && !rx_complete; step++) {
+        size_t length = isotp_session_can_tx(&sender, frame, sizeof(frame), NULL);
+        if(length > 0) { isotp_session_can_rx(&receiver, frame, length); }
+
+        length = isotp_session_can_tx(&receiver, frame, sizeof(frame), NULL);
+        if(length > 0) {
+            const uint8_t flag = frame[ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_IDX] & ISOTP_SPEC_FRAME_FLOWCONTROL_FC_FLAGS_MASK;
+            if(flag == ISOTP_SPEC_FC_FLAG_WAIT) { fc_wait_frames++; }
+            if(flag == ISOTP_SPEC_FC_FLAG_OVERFLOW_ABORT) { fc_overflow_frames++; }
+            isotp_session_can_rx(&sender, frame, length);
+        }
+    }
+
+    ok &= check(waits_requested == POLICY_WAITS, "policy asked again while flow control is held");
+    ok &= check(fc_wait_frames == 0, "no unpaced WAIT frames sent");
+    ok &= check(fc_overflow_frames == 0, "transfer not aborted");
+    ok &= check(rx_complete, "transfer completed");
+    ok &= check(memcmp(rx_buffer, payload, PAYLOAD_SIZE) == 0, "payload intact");
+
+    printf("%s\n", ok ? "[PASS] fc_policy" : "[FAIL] fc_policy");
+    return ok ? 0 : 1;
+}
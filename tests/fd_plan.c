@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <isotplib.h>
+#include <isotp_conversions.h>
+
+/*
+    CAN FD TX_DL planner
+
+    The frame size `isotp_spec_fd_plan_frame_size` picks for a message must cost the fewest bytes on the wire of all
+    CAN FD frame size steps, counted from the frames `isotp_session_can_tx` actually returns. This only holds when the
+    planner counts the same headers and padding as the session, so the 4095 byte boundary (where the first frame
+    escapes to the 32 bit length), `fd_header_force` and `padding_enabled` are covered.
+    Exits with 1 on failure.
+*/
+
+#define PAYLOAD_SIZE 4200
+
+static bool rx_complete = false;
+static size_t tx_frames = 0;
+
+static void cb_transmission_rx(void* context) {
+    (void)context;
+    rx_complete = true;
+}
+
+static bool check(const bool condition, const char* what, const size_t length, const size_t max_frame_size) {
+    if(!condition) {
+        printf("[FAIL] %s (%zu bytes, frames up to %zu)\n", what, length, max_frame_size);
+    }
+
+    return condition;
+}
+
+//  Sends `length` bytes in frames of up to `frame_size` bytes and returns the bytes on the wire (0 if not delivered)
+static size_t wire_cost(isotp_session_t* sender, isotp_session_t* receiver, const uint8_t* payload, const size_t length, const size_t frame_size, const size_t frame_overhead) {
+    rx_complete = false;
+    if(isotp_session_send_borrowed(sender, payload, length) != length) {
+        return 0;
+    }
+
+    uint8_t frame[ISOTP_SPEC_FD_LEN_MAX];
+    size_t cost = 0;
+    tx_frames = 0;
+    for(int step = 0; step < 1000 && !rx_complete; step++) {
+        size_t frame_length = isotp_session_can_tx(sender, frame, frame_size, NULL);
+        if(frame_length > 0) {
+            cost += frame_length + frame_overhead;
+            tx_frames++;
+            isotp_session_can_rx(receiver, frame, frame_length);
+        }
+
+        frame_length = isotp_session_can_tx(receiver, frame, sizeof(frame), NULL);
+        if(frame_length > 0) { isotp_session_can_rx(sender, frame, frame_length); }
+    }
+
+    const bool delivered = rx_complete && receiver->full_transmission_length == length;
+    isotp_session_idle(receiver);
+    return delivered ? cost : 0;
+}
+
+//  The planned frame size must cost no more than any frame size step up to `max_frame_size`. Single frames are never split.
+static bool check_plan(isotp_session_t* sender, isotp_session_t* receiver, const uint8_t* payload, const size_t length, const size_t max_frame_size, const size_t frame_overhead) {
+    const size_t planned = isotp_spec_fd_plan_frame_size(length, max_frame_size, 0, sender->protocol_config.fd_header_force, sender->protocol_config.padding_enabled, frame_overhead);
+    const size_t planned_cost = wire_cost(sender, receiver, payload, length, planned, frame_overhead);
+    if(planned_cost > 0 && tx_frames == 1) {
+        return check(planned == max_frame_size, "single frame keeps the frame size", length, max_frame_size);
+    }
+
+    size_t best_cost = SIZE_MAX;
+    for(uint8_t dlc = ISOTP_SPEC_FD_DLC_CLASSIC_MAX; dlc <= ISOTP_SPEC_FD_DLC_MAX && isotp_spec_fd_dlc_length(dlc) <= max_frame_size; dlc++) {
+        const size_t cost = wire_cost(sender, receiver, payload, length, isotp_spec_fd_dlc_length(dlc), frame_overhead);
+        if(cost > 0 && cost < best_cost) {
+            best_cost = cost;
+        }
+    }
+
+    bool ok = check(planned_cost > 0, "planned message delivered", length, max_frame_size);
+    ok &= check(planned_cost == best_cost, "planned frame size costs the fewest bytes", length, max_frame_size);
+    return ok;
+}
+
+static bool check_lengths(isotp_session_t* sender, isotp_session_t* receiver, const uint8_t* payload, const size_t first, const size_t last) {
+    bool ok = true;
+    for(size_t length = first; length <= last; length++) {
+        for(uint8_t dlc = ISOTP_SPEC_FD_DLC_CLASSIC_MAX + 1; dlc <= ISOTP_SPEC_FD_DLC_MAX; dlc++) {
+            ok &= check_plan(sender, receiver, payload, length, isotp_spec_fd_dlc_length(dlc), 0);
+            ok &= check_plan(sender, receiver, payload, length, isotp_spec_fd_dlc_length(dlc), ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES);
+        }
+
+        //  The session plans the same frame size
+        sender->protocol_config.fd_tx_dl_planned = true;
+        const size_t session_cost = wire_cost(sender, receiver, payload, length, ISOTP_SPEC_FD_LEN_MAX, ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES);
+        sender->protocol_config.fd_tx_dl_planned = false;
+        const size_t planned = isotp_spec_fd_plan_frame_size(length, ISOTP_SPEC_FD_LEN_MAX, 0, sender->protocol_config.fd_header_force, sender->protocol_config.padding_enabled, ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES);
+        ok &= check(session_cost == wire_cost(sender, receiver, payload, length, planned, ISOTP_SPEC_FD_FRAME_OVERHEAD_BYTES), "session uses the planned frame size", length, ISOTP_SPEC_FD_LEN_MAX);
+    }
+
+    return ok;
+}
+
+int main(void) {
+    static uint8_t payload[PAYLOAD_SIZE];
+    static uint8_t rx_buffer[PAYLOAD_SIZE];
+    for(size_t i = 0; i < PAYLOAD_SIZE; i++) {
+        payload[i] = (uint8_t)(i * 13);
+    }
+
+    isotp_session_t sender, receiver;
+    isotp_session_init(&sender, ISOTP_FORMAT_FD, NULL, 0, NULL, 0);
+    isotp_session_init(&receiver, ISOTP_FORMAT_FD, NULL, 0, rx_buffer, sizeof(rx_buffer));
+    receiver.callback_transmission_rx = cb_transmission_rx;
+    receiver.protocol_config.fc_default_request_size = 0;
+
+    //  Short messages, then the first frame escape to the 32 bit length at 4095 bytes, with and without CAN FD headers
+    //  on messages the classic headers cover and padding of short frames
+    bool ok = true;
+    for(int variant = 0; variant < 4; variant++) {
+        sender.protocol_config.fd_header_force = (variant & 1) != 0;
+        sender.protocol_config.padding_enabled = (variant & 2) != 0;
+        ok &= check_lengths(&sender, &receiver, payload, 1, 200);
+        ok &= check_lengths(&sender, &receiver, payload, 4090, 4100);
+    }
+
+    printf("%s\n", ok ? "[PASS] fd_plan" : "[FAIL] fd_plan");
+    return ok ? 0 : 1;
+}